@@ -0,0 +1,173 @@
+#include "detection_cache.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+// Files up to this size are hashed completely, larger ones are sampled
+constexpr size_t SAMPLE_COUNT = 16;
+constexpr size_t SAMPLE_BYTES = 64 * 1024;
+
+uint64_t fnv1a(const void* data, size_t length, uint64_t hash = FNV_OFFSET) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash the size and content of a file
+ * @param sampled Hash evenly spaced chunks instead of the whole file
+ */
+bool hashFile(const std::string& path, bool sampled, uint64_t& hash) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    uint64_t size = static_cast<uint64_t>(file.tellg());
+    hash = fnv1a(&size, sizeof(size));
+
+    std::vector<char> buffer(SAMPLE_BYTES);
+    if (!sampled || size <= SAMPLE_COUNT * SAMPLE_BYTES) {
+        file.seekg(0);
+        while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+            hash = fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+        }
+        return true;
+    }
+
+    uint64_t stride = (size - SAMPLE_BYTES) / (SAMPLE_COUNT - 1);
+    for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+        file.seekg(static_cast<std::streamoff>(i * stride));
+        if (!file.read(buffer.data(), buffer.size())) return false;
+        hash = fnv1a(buffer.data(), buffer.size(), hash);
+    }
+    return true;
+}
+
+} // namespace
+
+DetectionCache& DetectionCache::getInstance() {
+    static DetectionCache instance;
+    return instance;
+}
+
+std::string DetectionCache::computeKey(const std::string& videoPath, const std::string& modelPath,
+                                       cv::Size inputSize, float confidenceThreshold, const std::string& settings) {
+    uint64_t videoHash, modelHash;
+    if (!hashFile(videoPath, true, videoHash) || !hashFile(modelPath, false, modelHash)) {
+        return "";
+    }
+
+    // Thresholds that print the same are the same for caching purposes
+    char parameters[64];
+    int length = std::snprintf(parameters, sizeof(parameters), "%dx%d@%.4f",
+                               inputSize.width, inputSize.height, confidenceThreshold);
+
+    uint64_t hash = fnv1a(&videoHash, sizeof(videoHash));
+    hash = fnv1a(&modelHash, sizeof(modelHash), hash);
+    hash = fnv1a(parameters, static_cast<size_t>(length), hash);
+    hash = fnv1a(settings.data(), settings.size(), hash);
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+bool DetectionCache::open(const std::string& directory, const std::string& videoPath, const std::string& modelPath,
+                          cv::Size inputSize, float confidenceThreshold, const std::string& settings) {
+    close();
+
+    std::string key = computeKey(videoPath, modelPath, inputSize, confidenceThreshold, settings);
+    if (key.empty()) {
+        LOG_WARNING("Detection cache disabled: cannot read %s or %s", videoPath.c_str(), modelPath.c_str());
+        return false;
+    }
+
+    path = (fs::path(directory) / (key + ".det")).string();
+    tempPath = path + ".tmp";
+
+    if (fs::exists(path)) {
+        auto cached = std::make_unique<TrackLogReader>();
+        if (cached->open(path) && cached->isComplete()) {
+            reader = std::move(cached);
+            LOG_INFO("Detection cache hit: %s (%zu frames)", path.c_str(), reader->frameCount());
+            return true;
+        }
+        LOG_WARNING("Ignoring unreadable detection cache entry %s", path.c_str());
+    }
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    auto recording = std::make_unique<TrackLogWriter>(tempPath);
+    if (recording->isOpen()) {
+        writer = std::move(recording);
+        LOG_INFO("Detection cache miss, recording detections to %s", path.c_str());
+    }
+    return false;
+}
+
+bool DetectionCache::lookup(int64_t frameIndex, std::vector<cv::Rect>& detections) const {
+    long position = reader ? reader->findFrame(frameIndex) : -1;
+    if (position < 0) {
+        detections.clear();
+        return false;
+    }
+
+    std::vector<int> order;
+    TrackLogReader::decode(reader->frame(position), detections, order);
+    return true;
+}
+
+void DetectionCache::record(int64_t frameIndex, const std::vector<cv::Rect>& detections) {
+    if (!writer) return;
+
+    if (frameIndex != nextFrameIndex) {
+        gap = true;
+    }
+    nextFrameIndex = frameIndex + 1;
+
+    ids.resize(detections.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    writer->append(frameIndex, detections, ids);
+}
+
+void DetectionCache::close() {
+    if (writer) {
+        writer->close();
+        writer.reset();
+
+        std::error_code ec;
+        int64_t delivered = sourceFrames;
+        if (delivered > 0 && !gap && nextFrameIndex == delivered) {
+            fs::rename(tempPath, path, ec);
+            if (ec) {
+                LOG_ERROR("Failed to store detection cache entry %s: %s", path.c_str(), ec.message().c_str());
+            } else {
+                LOG_INFO("Detection cache entry stored: %s (%lld frames)", path.c_str(),
+                         static_cast<long long>(nextFrameIndex));
+            }
+        } else if (delivered > 0 && !gap) {
+            LOG_INFO("Only %lld of %lld frames were recorded, discarding detection cache recording",
+                     static_cast<long long>(nextFrameIndex), static_cast<long long>(delivered));
+            fs::remove(tempPath, ec);
+        } else {
+            LOG_INFO("Stream not processed completely, discarding detection cache recording");
+            fs::remove(tempPath, ec);
+        }
+    }
+
+    reader.reset();
+    nextFrameIndex = 0;
+    gap = false;
+    sourceFrames = -1;
+}
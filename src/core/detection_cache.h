@@ -0,0 +1,112 @@
+/**
+ * @file detection_cache.h
+ * @brief Defines the DetectionCache class, which replays stored detections instead of running inference
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "track_log.h"
+
+/**
+ * @class DetectionCache
+ * @brief On-disk cache of per-frame model detections
+ *
+ * A cache file holds the detections of every frame of one video for one model,
+ * input resolution and confidence threshold, and is named after a hash of those.
+ * It uses the track log format with each detection's position in the frame as its
+ * ID, so replayed detections keep the model's output order.
+ *
+ * On a hit the file is memory-mapped and the Preprocessor fills Frame::detections
+ * from it. On a miss the Tracker records the model output into a temporary file,
+ * which only becomes the cache entry once the whole stream has been processed.
+ */
+class DetectionCache {
+public:
+    /**
+     * @brief Get the singleton instance of DetectionCache
+     * @return Reference to the DetectionCache instance
+     */
+    static DetectionCache& getInstance();
+
+    /**
+     * @brief Look up the cache entry for a video, or start recording one
+     * @param directory Directory holding the cache files
+     * @param videoPath Video file whose content is hashed
+     * @param modelPath Model file whose content is hashed
+     * @param inputSize Model input resolution
+     * @param confidenceThreshold Detection confidence threshold
+     * @param settings Any other settings that change the detections, e.g. the tile layout
+     * @return true on a hit; on a miss detections are recorded if possible
+     */
+    bool open(const std::string& directory, const std::string& videoPath, const std::string& modelPath,
+              cv::Size inputSize, float confidenceThreshold, const std::string& settings = "");
+
+    /**
+     * @brief Compute the cache key for a combination of inputs
+     * @return Hex string, empty if a file cannot be read
+     */
+    static std::string computeKey(const std::string& videoPath, const std::string& modelPath,
+                                  cv::Size inputSize, float confidenceThreshold, const std::string& settings = "");
+
+    /**
+     * @brief Check whether detections are served from the cache
+     * @return true after a cache hit
+     */
+    bool isHit() const { return reader != nullptr; }
+
+    /**
+     * @brief Check whether model detections are being recorded
+     * @return true after a cache miss
+     */
+    bool isRecording() const { return writer != nullptr; }
+
+    /**
+     * @brief Get the cached detections of a frame
+     * @param frameIndex Frame::frameIndex of the frame
+     * @param detections Receives the detections
+     * @return false if the frame is not in the cache
+     */
+    bool lookup(int64_t frameIndex, std::vector<cv::Rect>& detections) const;
+
+    /**
+     * @brief Record the model detections of the next frame
+     * @param frameIndex Frame::frameIndex of the frame, expected to increase by one per call
+     * @param detections Model detections
+     */
+    void record(int64_t frameIndex, const std::vector<cv::Rect>& detections);
+
+    /**
+     * @brief Mark that the source has delivered its last frame
+     *
+     * Frames may still be in the pipeline at this point, so the recording only becomes
+     * the cache entry if all of them were recorded by the time the cache is closed.
+     * @param frameCount Number of frames the source delivered
+     */
+    void markComplete(int64_t frameCount) { sourceFrames = frameCount; }
+
+    /**
+     * @brief Close the cache; a recording of every frame the source delivered becomes the cache entry,
+     *        anything else is discarded
+     */
+    void close();
+
+private:
+    DetectionCache() = default;
+    DetectionCache(const DetectionCache&) = delete;
+    DetectionCache& operator=(const DetectionCache&) = delete;
+
+    std::unique_ptr<TrackLogReader> reader;    ///< Mapped cache entry after a hit
+    std::unique_ptr<TrackLogWriter> writer;    ///< Recording after a miss
+    std::string path;                          ///< Cache entry
+    std::string tempPath;                      ///< Recording, renamed to path when complete
+    std::vector<int> ids;                      ///< Reused detection order IDs for record()
+    int64_t nextFrameIndex = 0;                ///< Frame index record() expects next
+    bool gap = false;                          ///< A frame was missed while recording
+    std::atomic<int64_t> sourceFrames{-1};     ///< Frames the source delivered once it reached its end, else -1
+};
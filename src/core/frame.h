@@ -3,13 +3,39 @@
 #include <vector>
 #include <onnxruntime_cxx_api.h>
 #include <optional>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+struct InferenceRegion {
+    cv::Rect roi;                           // Area of Frame::original fed to one batch entry of the model input
+    float scaleX = 0.0f;                    // Model input pixels per roi pixel; 0 if unset, meaning stretched
+    float scaleY = 0.0f;
+    cv::Point2f pad;                        // Left and top padding of the scaled roi in the model input
+};
+
+struct InputTensorFormat {
+    bool uint8 = false;                     // Raw 0-255 pixels, normalized inside the model; float in [0, 1] otherwise
+    bool nhwc = false;                      // Channels interleaved (NHWC); planar (NCHW) otherwise
+};
 
 struct Frame {
     cv::Mat original;
     cv::Mat processed;
+    cv::Mat inputBlob;                      // Owns the data onnx_input refers to
     std::optional<Ort::Value> onnx_input;
+    std::vector<InferenceRegion> regions;   // One per batch entry of onnx_input, in batch order
     std::vector<cv::Rect> detections;
+    std::vector<float> scores;              // Confidence of each detection when the model ran, empty otherwise
     std::vector<int> trackIDs;
+    std::chrono::steady_clock::time_point captureTime; // When the frame was acquired from the source
+    int64_t frameIndex = -1;                // Position of the frame in the source stream
+    std::shared_ptr<void> sourceLease;      // Keeps source memory that original may view alive
+    bool hasDetections = false;             // Detections are known (supplied upstream or inferred), skip inference
+    bool reuseDetections = false;           // No change since the last inferred frame, reuse its detections
+    bool roiInference = false;              // Detect only around existing tracks; the Tracker builds the input
+    std::vector<cv::Rect> groundTruth;      // Ground truth boxes, when the source provides them
+    std::vector<int> groundTruthIDs;        // Ground truth IDs matching groundTruth
 
     Frame() = default;
     Frame(const Frame&) = delete;
@@ -8,7 +8,50 @@ FrameSource& FrameSource::getInstance() {
 }
 
 bool FrameSource::initialize() {
-    if (Config::getInputSource() == Config::InputSource::CAMERA) {
+    source = Config::getInputSource();
+    nextFrameIndex = 0;
+
+    if (source == Config::InputSource::SYNTHETIC) {
+        SyntheticSourceOptions options;
+        options.width = Config::getSyntheticWidth();
+        options.height = Config::getSyntheticHeight();
+        options.fps = Config::getSyntheticFPS();
+        options.numObjects = Config::getSyntheticObjects();
+        options.numFrames = Config::getSyntheticFrames();
+        options.seed = Config::getSyntheticSeed();
+        options.injectDetections = Config::getInjectGroundTruth();
+        synthetic = std::make_unique<SyntheticSource>(options);
+
+        LOG_INFO("Synthetic frame source initialized: %d objects at %dx%d",
+                 options.numObjects, options.width, options.height);
+        return true;
+    }
+
+    if (source == Config::InputSource::RAW) {
+        RawVideoSource::Format format;
+        if (!RawVideoSource::parseFormat(Config::getRawFormat(), format)) {
+            LOG_ERROR("Unknown raw video format: %s", Config::getRawFormat().c_str());
+            return false;
+        }
+        rawVideo = std::make_unique<RawVideoSource>(Config::getRawPath(), format,
+            cv::Size(Config::getRawWidth(), Config::getRawHeight()), Config::getRawFPS());
+        return rawVideo->open();
+    }
+
+    if (source == Config::InputSource::SHM) {
+        shmSource = std::make_unique<ShmFrameSource>(Config::getShmName(),
+                                                     std::chrono::milliseconds(Config::getShmTimeout()));
+        return shmSource->open();
+    }
+
+    if (source == Config::InputSource::IMAGE_SEQUENCE) {
+        imageSequence.reset();  // Stop the decode threads of a previous run first
+        imageSequence = std::make_unique<ImageSequenceSource>(Config::getImageDirectory(),
+                                                              Config::getDecodeThreads());
+        return imageSequence->open();
+    }
+
+    if (source == Config::InputSource::CAMERA) {
         cap.open(0);  // Open default camera
     } else {
         cap.open(Config::getVideoPath());
@@ -25,8 +68,42 @@ bool FrameSource::initialize() {
 }
 
 bool FrameSource::getNextFrame(Frame& frame) {
-    if (!cap.isOpened()) {
+    bool acquired = false;
+
+    if (source == Config::InputSource::SYNTHETIC) {
+        acquired = synthetic && synthetic->getNextFrame(frame);
+    } else if (source == Config::InputSource::IMAGE_SEQUENCE) {
+        acquired = imageSequence && imageSequence->getNextFrame(frame);
+    } else if (source == Config::InputSource::RAW) {
+        acquired = rawVideo && rawVideo->getNextFrame(frame);
+    } else if (source == Config::InputSource::SHM) {
+        acquired = shmSource && shmSource->getNextFrame(frame);
+    } else if (cap.isOpened()) {
+        acquired = cap.read(frame.original);
+    }
+
+    if (!acquired) {
         return false;
     }
-    return cap.read(frame.original);
+    // The shared-memory producer stamps frames when it captures them
+    if (source != Config::InputSource::SHM) {
+        frame.captureTime = std::chrono::steady_clock::now();
+    }
+    frame.frameIndex = nextFrameIndex++;
+    return true;
+}
+
+double FrameSource::getFrameRate() {
+    switch (source) {
+        case Config::InputSource::SYNTHETIC:
+            return synthetic ? synthetic->getFrameRate() : 0.0;
+        case Config::InputSource::RAW:
+            return rawVideo ? rawVideo->getFrameRate() : 0.0;
+        case Config::InputSource::SHM:
+            return shmSource ? shmSource->getFrameRate() : 0.0;
+        case Config::InputSource::IMAGE_SEQUENCE:
+            return 0.0;
+        default:
+            return cap.isOpened() ? cap.get(cv::CAP_PROP_FPS) : 0.0;
+    }
 }
\ No newline at end of file
@@ -6,7 +6,13 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include <memory>
 #include "frame.h"
+#include "synthetic_source.h"
+#include "image_sequence_source.h"
+#include "raw_video_source.h"
+#include "shm_frame_source.h"
+#include "config.h"
 
 /**
  * @class FrameSource
@@ -33,11 +39,29 @@ public:
      */
     bool getNextFrame(Frame& frame);
 
+    /**
+     * @brief Get the nominal frame rate of the source
+     * @return Frames per second, or 0 if the source does not report one
+     */
+    double getFrameRate();
+
+    /**
+     * @brief Get the number of frames acquired so far
+     * @return Frames delivered by getNextFrame()
+     */
+    int64_t getFrameCount() const { return nextFrameIndex; }
+
 private:
     FrameSource() = default;
     ~FrameSource() = default;
     FrameSource(const FrameSource&) = delete;
     FrameSource& operator=(const FrameSource&) = delete;
 
+    Config::InputSource source = Config::InputSource::VIDEO; /**< Source selected at initialization */
     cv::VideoCapture cap; /**< OpenCV VideoCapture object for frame acquisition */
+    std::unique_ptr<SyntheticSource> synthetic; /**< Generator for the synthetic source */
+    std::unique_ptr<ImageSequenceSource> imageSequence; /**< Decoder for the image sequence source */
+    std::unique_ptr<RawVideoSource> rawVideo; /**< Mapping for the raw video source */
+    std::unique_ptr<ShmFrameSource> shmSource; /**< Ring of the shared-memory source */
+    int64_t nextFrameIndex = 0; /**< Index assigned to the next acquired frame */
 };
\ No newline at end of file
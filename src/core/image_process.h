@@ -8,6 +8,10 @@
 #include <opencv2/opencv.hpp>
 #include <opencv2/dnn/dnn.hpp>
 #include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "frame.h"
 
 /**
  * @class ImageProcessor
@@ -56,28 +60,181 @@ public:
     /**
      * @brief Preprocess an image for ONNX model input
      * @param input_image Input image
+     * @param blob Receives the input data; the returned tensor refers to it, so it must outlive the tensor
      * @param memory_info ONNX runtime memory info
-     * @param input_node_dims Dimensions of the input node
+     * @param input_node_dims Dimensions of the input node in NCHW order
+     * @param format Element type and layout of the model input
      * @return ONNX Value containing the preprocessed image data
      */
-    static Ort::Value preprocessForONNX(const cv::Mat& input_image, const Ort::MemoryInfo& memory_info, const std::vector<int64_t>& input_node_dims) {
-        // Ensure input_image is already resized to the correct dimensions (640x640)
-        // input_node_dims[3]: width; input_node_dims[2]: height
+    static Ort::Value preprocessForONNX(const cv::Mat& input_image, cv::Mat& blob, const Ort::MemoryInfo& memory_info,
+                                        const std::vector<int64_t>& input_node_dims,
+                                        const InputTensorFormat& format = InputTensorFormat()) {
+        return preprocessBatchForONNX({input_image}, blob, memory_info, input_node_dims, format);
+    }
 
-        // Create blob from image
-        cv::Mat blob = cv::dnn::blobFromImage(input_image, 1.0/255.0, cv::Size(input_node_dims[3], input_node_dims[2]), cv::Scalar(0, 0, 0), false, false);
+    /**
+     * @brief Get the shape of a model input tensor in its memory layout
+     * @param input_node_dims Dimensions in NCHW order
+     * @param format Layout of the model input
+     * @return The dimensions, reordered to NHWC for channels-last inputs
+     */
+    static std::vector<int64_t> tensorShape(const std::vector<int64_t>& input_node_dims, const InputTensorFormat& format) {
+        if (!format.nhwc) {
+            return input_node_dims;
+        }
+        return {input_node_dims[0], input_node_dims[2], input_node_dims[3], input_node_dims[1]};
+    }
 
-        size_t input_tensor_size = blob.total() * blob.elemSize();
+    /**
+     * @brief Preprocess a batch of images for ONNX model input
+     *
+     * Float inputs are scaled to [0, 1]. 8-bit inputs keep the pixel values, a
+     * quarter of the bytes, and leave normalization to the model.
+     * @param images Input images; any not of the model input size are stretched to it
+     * @param blob Receives the input data; the returned tensor refers to it, so it must outlive the tensor
+     * @param memory_info ONNX runtime memory info
+     * @param input_node_dims Dimensions of the input node in NCHW order; the batch dimension is replaced by the number of images
+     * @param format Element type and layout of the model input
+     * @return ONNX Value containing the batch
+     */
+    static Ort::Value preprocessBatchForONNX(const std::vector<cv::Mat>& images, cv::Mat& blob, const Ort::MemoryInfo& memory_info,
+                                             const std::vector<int64_t>& input_node_dims,
+                                             const InputTensorFormat& format = InputTensorFormat()) {
+        cv::Size input_size(static_cast<int>(input_node_dims[3]), static_cast<int>(input_node_dims[2]));
+        double scale = format.uint8 ? 1.0 : 1.0 / 255.0;
 
-        // Create tensor
-        auto tensor = Ort::Value::CreateTensor<float>(
+        if (!format.nhwc) {
+            blob = cv::dnn::blobFromImages(images, scale, input_size, cv::Scalar(0, 0, 0), false, false,
+                                           format.uint8 ? CV_8U : CV_32F);
+        } else {
+            // Interleaved pixels are the images themselves, stacked: each is written into its band of rows
+            int type = format.uint8 ? CV_8UC3 : CV_32FC3;
+            blob.create(input_size.height * static_cast<int>(images.size()), input_size.width, type);
+            cv::Mat resized;
+            for (size_t i = 0; i < images.size(); ++i) {
+                cv::Mat target = blob.rowRange(static_cast<int>(i) * input_size.height,
+                                               static_cast<int>(i + 1) * input_size.height);
+                if (images[i].size() == input_size) {
+                    images[i].convertTo(target, type, scale);
+                } else if (format.uint8) {
+                    cv::resize(images[i], target, input_size, 0, 0, cv::INTER_LINEAR);
+                } else {
+                    cv::resize(images[i], resized, input_size, 0, 0, cv::INTER_LINEAR);
+                    resized.convertTo(target, type, scale);
+                }
+            }
+        }
+
+        std::vector<int64_t> dims = input_node_dims;
+        dims[0] = static_cast<int64_t>(images.size());
+        std::vector<int64_t> shape = tensorShape(dims, format);
+
+        return Ort::Value::CreateTensor(
             memory_info,
-            reinterpret_cast<float*>(blob.data),
-            input_tensor_size / sizeof(float),
-            input_node_dims.data(),
-            input_node_dims.size()
+            blob.data,
+            blob.total() * blob.elemSize(),
+            shape.data(),
+            shape.size(),
+            format.uint8 ? ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8 : ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT
         );
+    }
+
+    /**
+     * @brief Letterbox an image into a target size
+     *
+     * The image is scaled to fit while keeping its aspect ratio, centered and padded
+     * with gray, the way YOLO models are trained.
+     * @param image Input image
+     * @param target Output size
+     * @param region Receives the scale and padding of the mapping
+     * @return Image of exactly the target size
+     */
+    static cv::Mat letterbox(const cv::Mat& image, const cv::Size& target, InferenceRegion& region) {
+        double scale = std::min(static_cast<double>(target.width) / image.cols,
+                                static_cast<double>(target.height) / image.rows);
+        int width = std::clamp(static_cast<int>(std::lround(image.cols * scale)), 1, target.width);
+        int height = std::clamp(static_cast<int>(std::lround(image.rows * scale)), 1, target.height);
+        int left = (target.width - width) / 2;
+        int top = (target.height - height) / 2;
+
+        // Resize straight into the padded output
+        cv::Mat output(target, image.type(), cv::Scalar(114, 114, 114));
+        cv::Mat inner = output(cv::Rect(left, top, width, height));
+        cv::resize(image, inner, inner.size(), 0, 0, cv::INTER_LINEAR);
+
+        // Per-axis scales absorb the rounding of the scaled size
+        region.scaleX = static_cast<float>(width) / image.cols;
+        region.scaleY = static_cast<float>(height) / image.rows;
+        region.pad = cv::Point2f(static_cast<float>(left), static_cast<float>(top));
+        return output;
+    }
+
+    /**
+     * @brief Preprocess regions of an image as one batch for ONNX model input
+     * @param image Image the regions refer to
+     * @param regions Regions to infer, one batch entry each; their scale and padding are filled in
+     * @param letterbox Keep the aspect ratio of each region instead of stretching it to the input size
+     * @param blob Receives the input data; the returned tensor refers to it, so it must outlive the tensor
+     * @param memory_info ONNX runtime memory info
+     * @param input_node_dims Dimensions of the input node in NCHW order; the batch dimension is replaced by the number of regions
+     * @param format Element type and layout of the model input
+     * @return ONNX Value containing the batch
+     */
+    static Ort::Value preprocessRegionsForONNX(const cv::Mat& image, std::vector<InferenceRegion>& regions, bool letterbox,
+                                               cv::Mat& blob, const Ort::MemoryInfo& memory_info, const std::vector<int64_t>& input_node_dims,
+                                               const InputTensorFormat& format = InputTensorFormat()) {
+        cv::Size input_size(static_cast<int>(input_node_dims[3]), static_cast<int>(input_node_dims[2]));
+
+        std::vector<cv::Mat> images;
+        images.reserve(regions.size());
+        for (InferenceRegion& region : regions) {
+            if (letterbox) {
+                images.push_back(ImageProcessor::letterbox(image(region.roi), input_size, region));
+            } else {
+                // Stretched when packed into the blob
+                images.push_back(image(region.roi));
+                region.scaleX = static_cast<float>(input_size.width) / region.roi.width;
+                region.scaleY = static_cast<float>(input_size.height) / region.roi.height;
+                region.pad = cv::Point2f();
+            }
+        }
+
+        return preprocessBatchForONNX(images, blob, memory_info, input_node_dims, format);
+    }
+
+    /**
+     * @brief Cut a frame into a grid of overlapping square tiles
+     *
+     * Tiles are spread evenly so the first and last tile of each row and column are
+     * flush with the frame border; neighbouring tiles overlap by at least the
+     * requested fraction. A frame side shorter than the tile gives a single span.
+     * @param frameSize Size of the frame
+     * @param tileSize Side length of a tile in pixels
+     * @param overlap Minimum overlap between neighbouring tiles as a fraction of the tile size
+     * @return Tile rectangles in row-major order
+     */
+    static std::vector<cv::Rect> computeTiles(const cv::Size& frameSize, int tileSize, double overlap) {
+        auto spans = [&](int length) {
+            std::vector<std::pair<int, int>> result;  // start, size
+            if (length <= tileSize) {
+                result.emplace_back(0, length);
+                return result;
+            }
+            int stride = std::max(1, static_cast<int>(std::lround(tileSize * (1.0 - overlap))));
+            int count = static_cast<int>(std::ceil(static_cast<double>(length - tileSize) / stride)) + 1;
+            for (int i = 0; i < count; ++i) {
+                int start = static_cast<int>(std::lround(static_cast<double>(i) * (length - tileSize) / (count - 1)));
+                result.emplace_back(start, tileSize);
+            }
+            return result;
+        };
 
-        return tensor;
+        std::vector<cv::Rect> tiles;
+        for (const auto& row : spans(frameSize.height)) {
+            for (const auto& column : spans(frameSize.width)) {
+                tiles.emplace_back(column.first, row.first, column.second, row.second);
+            }
+        }
+        return tiles;
     }
 };
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "image_sequence_source.h"
+#include "logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+ImageSequenceSource::ImageSequenceSource(const std::string& directory, int numThreads)
+    : directory(directory), numThreads(std::max(1, numThreads)) {
+}
+
+ImageSequenceSource::~ImageSequenceSource() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cond.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool ImageSequenceSource::open() {
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (!entry.is_regular_file()) continue;
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c){ return std::tolower(c); });
+        if (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp") {
+            files.push_back(entry.path().string());
+        }
+    }
+
+    if (ec || files.empty()) {
+        LOG_ERROR("No images found in %s", directory.c_str());
+        return false;
+    }
+
+    // Sequences are expected to use zero-padded frame numbers
+    std::sort(files.begin(), files.end());
+
+    // Two slots per thread keep every worker busy while the consumer drains
+    slots.resize(numThreads * 2);
+    for (int i = 0; i < numThreads; ++i) {
+        workers.emplace_back(&ImageSequenceSource::decodeLoop, this);
+    }
+
+    LOG_INFO("Image sequence opened: %zu images, %d decode threads", files.size(), numThreads);
+    return true;
+}
+
+bool ImageSequenceSource::decode(const std::string& path, Slot& slot) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    slot.encoded.resize(static_cast<size_t>(size));
+    if (!file.read(reinterpret_cast<char*>(slot.encoded.data()), size)) return false;
+
+    // Decode in place only when no delivered frame still shares the buffer
+    if (slot.image.u && slot.image.u->refcount > 1) {
+        slot.image.release();
+    }
+    cv::imdecode(slot.encoded, cv::IMREAD_COLOR, &slot.image);
+    return !slot.image.empty();
+}
+
+void ImageSequenceSource::decodeLoop() {
+    while (true) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [this] {
+                return stopping || nextToDecode >= files.size() ||
+                       nextToDecode < nextToDeliver + slots.size();
+            });
+            if (stopping || nextToDecode >= files.size()) return;
+            index = nextToDecode++;
+        }
+
+        // The slot is free: its previous file has already been delivered
+        Slot& slot = slots[index % slots.size()];
+        if (!decode(files[index], slot)) {
+            LOG_WARNING("Failed to decode %s", files[index].c_str());
+            slot.image.release();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.index = index;
+            slot.ready = true;
+        }
+        cond.notify_all();
+    }
+}
+
+bool ImageSequenceSource::getNextFrame(Frame& frame) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (nextToDeliver < files.size()) {
+        Slot& slot = slots[nextToDeliver % slots.size()];
+        cond.wait(lock, [&] { return slot.ready && slot.index == nextToDeliver; });
+
+        slot.ready = false;
+        nextToDeliver++;
+        bool decoded = !slot.image.empty();
+        if (decoded) {
+            // Shares the slot buffer; it is reused once the frame is released
+            frame.original = slot.image;
+        }
+
+        lock.unlock();
+        cond.notify_all();
+        if (decoded) return true;
+        lock.lock();
+    }
+
+    return false;
+}
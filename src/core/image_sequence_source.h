@@ -0,0 +1,93 @@
+/**
+ * @file image_sequence_source.h
+ * @brief Defines the ImageSequenceSource class for directories of still images
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "frame.h"
+
+/**
+ * @class ImageSequenceSource
+ * @brief Decodes a directory of JPEG/PNG frames in parallel and delivers them in order
+ *
+ * The directory is listed once and sorted by file name. A small pool of worker
+ * threads reads and decodes files ahead of the consumer into a fixed ring of
+ * slots. Each slot keeps its encoded-bytes and image buffers across frames, so
+ * once the consumer has released a frame its memory is reused for the next file
+ * that lands in the same slot.
+ */
+class ImageSequenceSource {
+public:
+    /**
+     * @brief Constructor for the ImageSequenceSource class
+     * @param directory Directory containing the frames
+     * @param numThreads Number of decode threads
+     */
+    ImageSequenceSource(const std::string& directory, int numThreads);
+
+    /**
+     * @brief Destructor, stops the decode threads
+     */
+    ~ImageSequenceSource();
+
+    ImageSequenceSource(const ImageSequenceSource&) = delete;
+    ImageSequenceSource& operator=(const ImageSequenceSource&) = delete;
+
+    /**
+     * @brief List the directory and start decoding
+     * @return false if the directory contains no readable images
+     */
+    bool open();
+
+    /**
+     * @brief Get the next frame in file name order
+     * @param frame Receives the decoded image in Frame::original
+     * @return false at the end of the sequence
+     */
+    bool getNextFrame(Frame& frame);
+
+    /**
+     * @brief Get the number of images in the sequence
+     * @return Number of images
+     */
+    size_t size() const { return files.size(); }
+
+private:
+    struct Slot {
+        size_t index = 0;           ///< File index held by the slot
+        bool ready = false;         ///< Decode finished and not yet delivered
+        std::vector<uchar> encoded; ///< Reused buffer for the file contents
+        cv::Mat image;              ///< Reused buffer for the decoded image
+    };
+
+    /**
+     * @brief Decode loop run by every worker thread
+     */
+    void decodeLoop();
+
+    /**
+     * @brief Read and decode one file into a slot
+     * @return true on success
+     */
+    bool decode(const std::string& path, Slot& slot);
+
+    std::string directory;             ///< Directory of the sequence
+    int numThreads;                    ///< Number of decode threads
+    std::vector<std::string> files;    ///< Sorted image paths
+    std::vector<Slot> slots;           ///< Ring of decode slots, file i uses slot i % size
+    std::vector<std::thread> workers;  ///< Decode threads
+
+    std::mutex mutex;                  ///< Protects the fields below and the slot states
+    std::condition_variable cond;      ///< Signals decoded and delivered slots
+    size_t nextToDecode = 0;           ///< Next file to hand to a worker
+    size_t nextToDeliver = 0;          ///< Next file to return from getNextFrame
+    bool stopping = false;             ///< Set to stop the workers
+};
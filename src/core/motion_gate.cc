@@ -0,0 +1,90 @@
+#include "motion_gate.h"
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+MotionGate::MotionGate(int width, double threshold, int refreshInterval)
+    : width((std::max(width, BLOCK_SIZE) + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE),
+      threshold(threshold),
+      refreshInterval(refreshInterval) {
+}
+
+uint64_t MotionGate::sumAbsDiff(const uint8_t* a, const uint8_t* b, size_t length) {
+    uint64_t sum = 0;
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    __m128i total = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        // Two 16-bit sums, one per 8-byte half, zero-extended to 64 bits
+        total = _mm_add_epi64(total, _mm_sad_epu8(va, vb));
+    }
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), total);
+    sum = lanes[0] + lanes[1];
+#elif defined(__ARM_NEON)
+    uint64x2_t total = vdupq_n_u64(0);
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t diff = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        total = vpadalq_u32(total, vpaddlq_u16(vpaddlq_u8(diff)));
+    }
+    sum = vgetq_lane_u64(total, 0) + vgetq_lane_u64(total, 1);
+#endif
+
+    for (; i < length; ++i) {
+        sum += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+    }
+    return sum;
+}
+
+double MotionGate::maxBlockDifference(const cv::Mat& current, const cv::Mat& previous) const {
+    int blocksX = current.cols / BLOCK_SIZE;
+    int blocksY = current.rows / BLOCK_SIZE;
+    uint64_t maxSum = 0;
+
+    std::vector<uint64_t> rowSums(blocksX);
+    for (int by = 0; by < blocksY; ++by) {
+        std::fill(rowSums.begin(), rowSums.end(), 0);
+        for (int y = by * BLOCK_SIZE; y < (by + 1) * BLOCK_SIZE; ++y) {
+            const uint8_t* a = current.ptr<uint8_t>(y);
+            const uint8_t* b = previous.ptr<uint8_t>(y);
+            for (int bx = 0; bx < blocksX; ++bx) {
+                rowSums[bx] += sumAbsDiff(a + bx * BLOCK_SIZE, b + bx * BLOCK_SIZE, BLOCK_SIZE);
+            }
+        }
+        maxSum = std::max(maxSum, *std::max_element(rowSums.begin(), rowSums.end()));
+    }
+
+    return static_cast<double>(maxSum) / (BLOCK_SIZE * BLOCK_SIZE);
+}
+
+bool MotionGate::shouldInfer(const cv::Mat& frame) {
+    if (frame.empty()) return true;
+
+    // Block rows need whole blocks too, so round the height as well
+    int height = std::max(BLOCK_SIZE, (width * frame.rows / frame.cols + BLOCK_SIZE / 2) / BLOCK_SIZE * BLOCK_SIZE);
+    cv::resize(frame, small, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+    if (small.channels() == 3) {
+        cv::cvtColor(small, current, cv::COLOR_BGR2GRAY);
+    } else {
+        small.copyTo(current);
+    }
+
+    bool refresh = reference.empty() || reference.size() != current.size() ||
+                   (refreshInterval > 0 && framesSinceInference + 1 >= refreshInterval);
+    if (!refresh && maxBlockDifference(current, reference) <= threshold) {
+        framesSinceInference++;
+        return false;
+    }
+
+    std::swap(reference, current);
+    framesSinceInference = 0;
+    return true;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file motion_gate.h
+ * @brief Defines the MotionGate class, which skips inference on frames without change
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class MotionGate
+ * @brief Cheap change detector deciding whether a frame needs a new inference
+ *
+ * Each frame is reduced to a small grayscale image and compared with the image
+ * of the last frame that was sent to the detector. The comparison is a sum of
+ * absolute differences over 16x16 blocks, so a small moving object is not
+ * averaged away by a large static background. A frame passes the gate when any
+ * block's mean difference exceeds the threshold, or when the last inference is
+ * older than the refresh interval.
+ */
+class MotionGate {
+public:
+    /**
+     * @brief Constructor for the MotionGate class
+     * @param width Width of the comparison image, rounded up to a multiple of 16
+     * @param threshold Mean absolute difference per pixel (0-255) that counts as change
+     * @param refreshInterval Maximum number of frames between inferences, 0 for no limit
+     */
+    MotionGate(int width, double threshold, int refreshInterval);
+
+    /**
+     * @brief Decide whether a frame needs inference
+     *
+     * A frame that passes becomes the new reference.
+     * @param frame BGR or grayscale frame
+     * @return true if the detector should run on this frame
+     */
+    bool shouldInfer(const cv::Mat& frame);
+
+    /**
+     * @brief Sum of absolute differences of two byte arrays
+     *
+     * Uses SSE2 or NEON when available.
+     * @param a First array
+     * @param b Second array
+     * @param length Number of bytes
+     * @return Sum of |a[i] - b[i]|
+     */
+    static uint64_t sumAbsDiff(const uint8_t* a, const uint8_t* b, size_t length);
+
+private:
+    /**
+     * @brief Largest mean absolute difference of any block between two images
+     */
+    double maxBlockDifference(const cv::Mat& current, const cv::Mat& previous) const;
+
+    static constexpr int BLOCK_SIZE = 16;  ///< Side length of a comparison block
+
+    int width;                 ///< Width of the comparison image
+    double threshold;          ///< Per-pixel mean difference that counts as change
+    int refreshInterval;       ///< Maximum frames between inferences
+    cv::Mat reference;         ///< Comparison image of the last inferred frame
+    cv::Mat small;             ///< Reused downscaled frame
+    cv::Mat current;           ///< Reused comparison image of the current frame
+    int framesSinceInference = 0;  ///< Frames gated since the reference was taken
+};
@@ -1,12 +1,11 @@
 #include "onnx_model.h"
 #include "logger.h"
 #include "config.h"
+#include "image_process.h"
 #include <opencv2/dnn/dnn.hpp>
+#include <algorithm>
 #include <chrono>
-
-// Define fixed input dimensions, as the model's expected input
-const int INPUT_WIDTH = 640;
-const int INPUT_HEIGHT = 640;
+#include <cstring>
 
 ONNXModel::ONNXModel() : env(ORT_LOGGING_LEVEL_WARNING, "ONNXModel") {}
 
@@ -15,6 +14,10 @@ ONNXModel& ONNXModel::getInstance() {
     return instance;
 }
 
+cv::Size ONNXModel::getInputSize() {
+    return cv::Size(Config::getInputWidth(), Config::getInputHeight());
+}
+
 bool ONNXModel::loadModel(const std::string& model_path) {
     try {
         // Enable multithreading
@@ -39,10 +42,48 @@ bool ONNXModel::loadModel(const std::string& model_path) {
 
         input_node_names = {"images"};
         output_node_names = {"output"};
-        input_node_dims = {1, 3, INPUT_HEIGHT, INPUT_WIDTH};
+        input_node_dims = {1, 3, Config::getInputHeight(), Config::getInputWidth()};
+
+        Ort::TypeInfo input_type_info = session.GetInputTypeInfo(0);
+        auto input_info = input_type_info.GetTensorTypeAndShapeInfo();
+        std::vector<int64_t> model_input_shape = input_info.GetShape();
+
+        // Models exported with normalization in the graph take 8-bit pixels, a quarter of the float input size
+        ONNXTensorElementDataType input_type = input_info.GetElementType();
+        if (input_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT && input_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
+            LOG_ERROR("Model input element type %d is not supported, export the model with a float or uint8 input",
+                      static_cast<int>(input_type));
+            return false;
+        }
+        input_format.uint8 = input_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+        // Channels last when the last dimension holds the colors; input_node_dims stays NCHW either way
+        input_format.nhwc = model_input_shape.size() == 4 && model_input_shape[3] == 3 && model_input_shape[1] != 3;
+        size_t height_axis = input_format.nhwc ? 1 : 2;
+        size_t width_axis = height_axis + 1;
+
+        // A model exported with a fixed resolution only accepts inputs of that size
+        if (model_input_shape.size() == 4 && model_input_shape[height_axis] > 0 && model_input_shape[width_axis] > 0 &&
+            (model_input_shape[height_axis] != input_node_dims[2] || model_input_shape[width_axis] != input_node_dims[3])) {
+            LOG_ERROR("Model expects %ldx%ld input, configured input size is %ldx%ld; set input_width and input_height",
+                      model_input_shape[width_axis], model_input_shape[height_axis], input_node_dims[3], input_node_dims[2]);
+            return false;
+        }
+        dynamic_input_size = model_input_shape.size() == 4 && model_input_shape[height_axis] <= 0 &&
+                             model_input_shape[width_axis] <= 0;
 
-        LOG_INFO("ONNX model loaded successfully with input dimensions: %ldx%ldx%ldx%ld",
-             input_node_dims[0], input_node_dims[1], input_node_dims[2], input_node_dims[3]);
+        // Batched inference needs a dynamic batch dimension
+        fixed_batch_size = model_input_shape.empty() || model_input_shape[0] <= 0 ? 0
+                                                                                   : static_cast<int>(model_input_shape[0]);
+        LOG_INFO("Model batch size: %s", fixed_batch_size == 0 ? "dynamic"
+                                                              : std::to_string(fixed_batch_size).c_str());
+
+        // A static output shape lets every binding context preallocate its output
+        output_node_dims = session.GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        idle_contexts.clear();
+
+        LOG_INFO("ONNX model loaded successfully with input dimensions: %ldx%ldx%ldx%ld, %s %s",
+             input_node_dims[0], input_node_dims[1], input_node_dims[2], input_node_dims[3],
+             input_format.uint8 ? "uint8" : "float", input_format.nhwc ? "NHWC" : "NCHW");
         return true;
     } catch (const Ort::Exception& e) {
         LOG_ERROR("Error loading ONNX model: %s", e.what());
@@ -50,6 +91,45 @@ bool ONNXModel::loadModel(const std::string& model_path) {
     }
 }
 
+void ONNXModel::warmUp(int runs) {
+    if (runs <= 0 || input_node_dims.empty()) return;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // A frame's worth of blank input; the runs only read it, so they share one tensor
+    int64_t batch = fixed_batch_size > 0 ? fixed_batch_size : 1;
+    std::vector<int64_t> dims = ImageProcessor::tensorShape(
+        {batch, input_node_dims[1], input_node_dims[2], input_node_dims[3]}, input_format);
+    size_t bytes = static_cast<size_t>(batch * dims[1] * dims[2] * dims[3]) * (input_format.uint8 ? 1 : sizeof(float));
+    std::vector<uint8_t> blank(bytes, 0);
+    Ort::Value input = Ort::Value::CreateTensor(memory_info, blank.data(), bytes, dims.data(), dims.size(),
+                                                input_format.uint8 ? ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8
+                                                                   : ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+    InferenceRegion region;
+    region.roi = cv::Rect(cv::Point(0, 0), getInputSize());
+    std::vector<InferenceRegion> regions(static_cast<size_t>(batch), region);
+
+    size_t concurrent = static_cast<size_t>(std::max(1, Config::getInferenceInFlight()));
+    double first_ms = 0.0;
+    for (int run = 0; run < runs; ++run) {
+        auto run_start = std::chrono::steady_clock::now();
+        std::vector<std::future<std::vector<cv::Rect>>> pending;
+        for (size_t i = 0; i < concurrent; ++i) {
+            pending.push_back(detectAsync(input, regions));
+        }
+        for (auto& result : pending) {
+            result.get();
+        }
+        if (run == 0) {
+            first_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - run_start).count();
+        }
+    }
+
+    double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Model warmed up with %d runs in %.1f ms (first %.1f ms, then %.1f ms per run)", runs, total_ms, first_ms,
+             runs > 1 ? (total_ms - first_ms) / (runs - 1) : first_ms);
+}
+
 void ONNXModel::appendCoreMLExecutionProvider() {
     #if __has_include(PROVIDER_HEADER(coreml))
         #include PROVIDER_HEADER(coreml)
@@ -83,53 +163,205 @@ void ONNXModel::appendCUDAExecutionProvider() {
 }
 
 std::vector<cv::Rect> ONNXModel::detect(const Ort::Value& input_tensor, const cv::Size& original_image_size) {
+    return detect(input_tensor, {InferenceRegion{cv::Rect(cv::Point(0, 0), original_image_size)}});
+}
+
+std::vector<cv::Rect> ONNXModel::detect(const Ort::Value& input_tensor, const std::vector<InferenceRegion>& regions,
+                                        std::vector<float>* scores) {
     auto start = std::chrono::high_resolution_clock::now();
 
-    std::vector<Ort::Value> input_tensors;
-    input_tensors.push_back(std::move(const_cast<Ort::Value&>(input_tensor)));
+    std::vector<int64_t> dims = input_tensor.GetTensorTypeAndShapeInfo().GetShape();
+    size_t batch = dims.empty() ? 0 : static_cast<size_t>(dims[0]);
+    if (batch == 0 || batch != regions.size()) {
+        LOG_ERROR("Input batch of %zu does not match %zu regions", batch, regions.size());
+        return std::vector<cv::Rect>();
+    }
 
-    std::vector<Ort::Value> output_tensors;
-    try {
-        output_tensors = session.Run(Ort::RunOptions{nullptr},
-            input_node_names.data(), input_tensors.data(), input_tensors.size(),
-            output_node_names.data(), output_node_names.size());
-    } catch (const Ort::Exception& e) {
-        LOG_ERROR("Error during inference: %s", e.what());
+    // Run the whole batch at once if the model and configuration allow it, otherwise in slices
+    size_t slice = batch;
+    if (fixed_batch_size > 0) {
+        slice = static_cast<size_t>(fixed_batch_size);
+    } else if (Config::getTileMaxBatch() > 0) {
+        slice = std::min(batch, static_cast<size_t>(Config::getTileMaxBatch()));
+    }
+    if (batch % slice != 0 && fixed_batch_size > 0) {
+        LOG_ERROR("Model has a fixed batch size of %d, cannot run a batch of %zu", fixed_batch_size, batch);
         return std::vector<cv::Rect>();
     }
 
+    std::vector<cv::Rect> boxes;
+    std::vector<float> confidences;
+    std::unique_ptr<BindingContext> context = acquireContext();
+
+    for (size_t first = 0; first < batch; first += slice) {
+        size_t count = std::min(slice, batch - first);
+
+        const float* output_data = nullptr;
+        size_t output_rows = 0;
+        std::vector<Ort::Value> output_values;
+        try {
+            runSlice(*context, input_tensor, first, count, output_data, output_rows, output_values);
+        } catch (const Ort::Exception& e) {
+            LOG_ERROR("Error during inference: %s", e.what());
+            releaseContext(std::move(context));
+            return std::vector<cv::Rect>();
+        }
+
+        postprocess(output_data, output_rows, regions, first, boxes, confidences);
+    }
+    releaseContext(std::move(context));
+
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    LOG_DEBUG("[ONNXModel] Inference time: %lld µs", duration.count());
+    LOG_DEBUG("[ONNXModel] Inference time: %lld µs (%zu regions)", duration.count(), batch);
+
+    // Objects on tile seams are found in several regions
+    if (regions.size() > 1 && !boxes.empty()) {
+        std::vector<int> keep;
+        cv::dnn::NMSBoxes(boxes, confidences, Config::getConfidenceThreshold(), Config::getTileNMSThreshold(), keep);
+
+        std::vector<cv::Rect> merged;
+        std::vector<float> merged_confidences;
+        for (int index : keep) {
+            merged.push_back(boxes[index]);
+            merged_confidences.push_back(confidences[index]);
+        }
+        boxes.swap(merged);
+        confidences.swap(merged_confidences);
+    }
 
-    return postprocess(output_tensors.front(), original_image_size);
+    if (scores) {
+        *scores = std::move(confidences);
+    }
+    return boxes;
 }
 
-std::vector<cv::Rect> ONNXModel::postprocess(const Ort::Value& output_tensor, const cv::Size& original_image_size) {
-    auto start = std::chrono::high_resolution_clock::now();
+std::future<std::vector<cv::Rect>> ONNXModel::detectAsync(const Ort::Value& input_tensor,
+                                                          std::vector<InferenceRegion> regions,
+                                                          std::vector<float>* scores) {
+    // One thread per frame that may be in flight; Session::Run is safe to call concurrently
+    std::call_once(executor_once, [this] {
+        executor = std::make_unique<WorkStealingPool>(static_cast<size_t>(Config::getInferenceInFlight()));
+    });
 
-    std::vector<cv::Rect> bounding_boxes;
+    auto task = std::make_shared<std::packaged_task<std::vector<cv::Rect>()>>(
+        [this, &input_tensor, regions = std::move(regions), scores] { return detect(input_tensor, regions, scores); });
+    std::future<std::vector<cv::Rect>> result = task->get_future();
+    executor->submit([task] { (*task)(); });
+    return result;
+}
+
+std::unique_ptr<ONNXModel::BindingContext> ONNXModel::acquireContext() {
+    {
+        std::lock_guard<std::mutex> lock(context_mutex);
+        if (!idle_contexts.empty()) {
+            std::unique_ptr<BindingContext> context = std::move(idle_contexts.back());
+            idle_contexts.pop_back();
+            return context;
+        }
+    }
 
-    const float* output_data = output_tensor.GetTensorData<float>();
-    size_t num_detected = output_tensor.GetTensorTypeAndShapeInfo().GetElementCount() / 7;
+    // One context per concurrent caller; the outputs stay bound for its lifetime
+    auto context = std::make_unique<BindingContext>();
+    context->binding = Ort::IoBinding(session);
+
+    bool static_output = !output_node_dims.empty() &&
+        std::all_of(output_node_dims.begin(), output_node_dims.end(), [](int64_t dim) { return dim > 0; });
+    if (static_output) {
+        size_t elements = 1;
+        for (int64_t dim : output_node_dims) elements *= static_cast<size_t>(dim);
+        context->output_buffer.resize(elements);
+        context->output_tensor = Ort::Value::CreateTensor<float>(memory_info, context->output_buffer.data(), elements,
+                                                                 output_node_dims.data(), output_node_dims.size());
+        context->binding.BindOutput(output_node_names[0], context->output_tensor);
+    } else {
+        // The number of detections varies, ONNX Runtime allocates the output from its arena
+        context->binding.BindOutput(output_node_names[0], memory_info);
+    }
+    return context;
+}
+
+void ONNXModel::releaseContext(std::unique_ptr<BindingContext> context) {
+    std::lock_guard<std::mutex> lock(context_mutex);
+    idle_contexts.push_back(std::move(context));
+}
+
+void ONNXModel::runSlice(BindingContext& context, const Ort::Value& input_tensor, size_t first, size_t count,
+                         const float*& output_data, size_t& output_rows, std::vector<Ort::Value>& output_values) {
+    auto input_info = input_tensor.GetTensorTypeAndShapeInfo();
+    std::vector<int64_t> dims = input_info.GetShape();
+    size_t batch = static_cast<size_t>(dims[0]);
+
+    if (count == batch) {
+        // The caller's tensor is bound as it is, nothing is copied
+        context.binding.BindInput(input_node_names[0], input_tensor);
+        context.slice_bound = false;
+    } else {
+        // Copy the slice into a buffer of the context, allocated and bound once per shape
+        ONNXTensorElementDataType type = input_info.GetElementType();
+        size_t element_size = type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8 ? 1 : sizeof(float);
+        size_t image_bytes = input_info.GetElementCount() / batch * element_size;
+        size_t bytes = image_bytes * count;
+        dims[0] = static_cast<int64_t>(count);
+        if (context.slice_dims != dims) {
+            context.slice_buffer.assign(bytes, 0);
+            context.slice_tensor = Ort::Value::CreateTensor(memory_info, context.slice_buffer.data(), bytes,
+                                                            dims.data(), dims.size(), type);
+            context.slice_dims = dims;
+            context.slice_bound = false;
+        }
+        std::memcpy(context.slice_buffer.data(),
+                    static_cast<const uint8_t*>(input_tensor.GetTensorRawData()) + first * image_bytes, bytes);
+        if (!context.slice_bound) {
+            context.binding.BindInput(input_node_names[0], context.slice_tensor);
+            context.slice_bound = true;
+        }
+    }
+
+    session.Run(Ort::RunOptions{nullptr}, context.binding);
+
+    if (!context.output_buffer.empty()) {
+        output_data = context.output_buffer.data();
+        output_rows = context.output_buffer.size() / 7;
+    } else {
+        output_values = context.binding.GetOutputValues();
+        output_data = output_values.front().GetTensorData<float>();
+        output_rows = output_values.front().GetTensorTypeAndShapeInfo().GetElementCount() / 7;
+    }
+}
+
+void ONNXModel::postprocess(const float* output_data, size_t num_detected, const std::vector<InferenceRegion>& regions,
+                            size_t first_region, std::vector<cv::Rect>& boxes, std::vector<float>& scores) {
+    auto start = std::chrono::high_resolution_clock::now();
+    const float confidence_threshold = Config::getConfidenceThreshold();
 
     for (size_t i = 0; i < num_detected; ++i) {
         size_t base_index = i * 7;
         float confidence = output_data[base_index + 5];
 
-        if (confidence > Config::getConfidenceThreshold()) {
-            float x = output_data[base_index + 1] / INPUT_WIDTH * original_image_size.width;
-            float y = output_data[base_index + 2] / INPUT_HEIGHT * original_image_size.height;
-            float w = (output_data[base_index + 3] - output_data[base_index + 1]) / INPUT_WIDTH * original_image_size.width;
-            float h = (output_data[base_index + 4] - output_data[base_index + 2]) / INPUT_HEIGHT * original_image_size.height;
+        if (confidence > confidence_threshold) {
+            // Column 0 is the batch entry the detection belongs to
+            float batch_id = output_data[base_index];
+            size_t region_index = first_region + static_cast<size_t>(std::max(0.0f, batch_id));
+            if (region_index >= regions.size()) continue;
+            const InferenceRegion& region = regions[region_index];
 
-            bounding_boxes.emplace_back(x, y, w, h);
+            // Undo the padding and scaling the region was preprocessed with; unset means stretched
+            float scale_x = region.scaleX > 0.0f ? region.scaleX
+                                                 : static_cast<float>(input_node_dims[3]) / region.roi.width;
+            float scale_y = region.scaleY > 0.0f ? region.scaleY
+                                                 : static_cast<float>(input_node_dims[2]) / region.roi.height;
+            float x = region.roi.x + (output_data[base_index + 1] - region.pad.x) / scale_x;
+            float y = region.roi.y + (output_data[base_index + 2] - region.pad.y) / scale_y;
+            float w = (output_data[base_index + 3] - output_data[base_index + 1]) / scale_x;
+            float h = (output_data[base_index + 4] - output_data[base_index + 2]) / scale_y;
+
+            boxes.emplace_back(x, y, w, h);
+            scores.push_back(confidence);
         }
     }
 
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     LOG_DEBUG("[ONNXModel] Postprocessing time: %lld µs", duration.count());
-
-    return bounding_boxes;
-}
\ No newline at end of file
+}
@@ -6,10 +6,15 @@
 #ifndef ONNX_MODEL_H
 #define ONNX_MODEL_H
 
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <opencv2/opencv.hpp>
 #include <onnxruntime_cxx_api.h>
+#include "frame.h"
+#include "work_stealing_pool.h"
 
 // Simplified macro definition
 #define PROVIDER_HEADER(provider) <onnxruntime_##provider##_provider_factory.h>
@@ -41,6 +46,45 @@ public:
      */
     std::vector<cv::Rect> detect(const Ort::Value& input_tensor, const cv::Size& original_image_size);
 
+    /**
+     * @brief Perform object detection on a batch of image regions
+     *
+     * Batch entry i of the input tensor covers regions[i] of the original image. The
+     * batch runs in one call when the model accepts it, otherwise in slices of the
+     * model's fixed batch size. With more than one region, overlapping detections
+     * from different regions are merged by non-maximum suppression.
+     * @param input_tensor Input tensor with one batch entry per region
+     * @param regions Image areas of the batch entries
+     * @param scores Receives the confidence of each returned box, if not null
+     * @return Vector of detected object bounding boxes in original image coordinates
+     */
+    std::vector<cv::Rect> detect(const Ort::Value& input_tensor, const std::vector<InferenceRegion>& regions,
+                                 std::vector<float>* scores = nullptr);
+
+    /**
+     * @brief Start object detection on a batch of image regions without waiting for it
+     *
+     * The batch runs on the model's inference executor, so the caller can prepare
+     * or finish other frames meanwhile. The input tensor must stay alive and in
+     * place until the future is ready.
+     * @param input_tensor Input tensor with one batch entry per region
+     * @param regions Image areas of the batch entries
+     * @param scores Receives the confidence of each returned box before the future is ready, if not null
+     * @return Future receiving the detected boxes in original image coordinates
+     */
+    std::future<std::vector<cv::Rect>> detectAsync(const Ort::Value& input_tensor, std::vector<InferenceRegion> regions,
+                                                   std::vector<float>* scores = nullptr);
+
+    /**
+     * @brief Run inferences on a blank input so the first frames run at steady-state speed
+     *
+     * The first runs of a session select kernels and grow its memory arena. Each
+     * warm-up run starts one detection per in-flight slot at once, so every
+     * binding context the pipeline will use is created and bound here.
+     * @param runs Number of warm-up rounds
+     */
+    void warmUp(int runs);
+
     /**
      * @brief Get the memory info for ONNX runtime
      * @return Reference to the Ort::MemoryInfo object
@@ -49,10 +93,34 @@ public:
 
     /**
      * @brief Get the input node dimensions
-     * @return Reference to the vector of input node dimensions
+     * @return Reference to the vector of input node dimensions, in NCHW order whatever the model layout
      */
     const std::vector<int64_t>& getInputNodeDims() const { return input_node_dims; }
 
+    /**
+     * @brief Get the resolution images are resized to for inference
+     * @return Model input width and height from the configuration, known before the model is loaded
+     */
+    static cv::Size getInputSize();
+
+    /**
+     * @brief Get the batch size the model was exported with
+     * @return Fixed batch size, or 0 if the batch dimension is dynamic
+     */
+    int getFixedBatchSize() const { return fixed_batch_size; }
+
+    /**
+     * @brief Check whether the model accepts input resolutions other than the configured one
+     * @return true if the spatial input dimensions are dynamic
+     */
+    bool hasDynamicInputSize() const { return dynamic_input_size; }
+
+    /**
+     * @brief Get the element type and layout of the model input
+     * @return Input format, detected when the model is loaded
+     */
+    const InputTensorFormat& getInputFormat() const { return input_format; }
+
 private:
     ONNXModel();
     ~ONNXModel() = default;
@@ -70,12 +138,55 @@ private:
     void appendCUDAExecutionProvider();
 
     /**
-     * @brief Post-process the output tensor to get bounding boxes
-     * @param output_tensor Output tensor from the model
-     * @param original_image_size Size of the original input image
-     * @return Vector of detected object bounding boxes
+     * @struct BindingContext
+     * @brief An IoBinding with its own buffers, reused across runs
+     *
+     * A context serves one inference at a time; concurrent callers each take their own.
+     */
+    struct BindingContext {
+        Ort::IoBinding binding{nullptr};        ///< Inputs and outputs bound to the session
+        std::vector<int64_t> slice_dims;        ///< Shape slice_buffer was allocated for
+        std::vector<uint8_t> slice_buffer;      ///< Copy of a batch slice, for models with a fixed batch size
+        Ort::Value slice_tensor{nullptr};       ///< Tensor over slice_buffer
+        std::vector<float> output_buffer;       ///< Preallocated output, empty if the output shape is dynamic
+        Ort::Value output_tensor{nullptr};      ///< Tensor over output_buffer
+        bool slice_bound = false;               ///< slice_tensor is the bound input
+    };
+
+    /**
+     * @brief Take an idle binding context, or create one with its outputs bound
+     */
+    std::unique_ptr<BindingContext> acquireContext();
+
+    /**
+     * @brief Return a binding context for reuse
      */
-    std::vector<cv::Rect> postprocess(const Ort::Value& output_tensor, const cv::Size& original_image_size);
+    void releaseContext(std::unique_ptr<BindingContext> context);
+
+    /**
+     * @brief Run one batch slice through a binding context
+     * @param context Context to run with
+     * @param input_tensor Caller's input tensor
+     * @param first First batch entry of the slice
+     * @param count Number of batch entries in the slice
+     * @param output_data Receives the detections, valid until the context is reused
+     * @param output_rows Receives the number of detections
+     * @param output_values Keeps outputs allocated by ONNX Runtime alive
+     */
+    void runSlice(BindingContext& context, const Ort::Value& input_tensor, size_t first, size_t count,
+                  const float*& output_data, size_t& output_rows, std::vector<Ort::Value>& output_values);
+
+    /**
+     * @brief Post-process the model output to get bounding boxes
+     * @param output_data Detections of the model, 7 values each
+     * @param num_detected Number of detections
+     * @param regions Image areas of all batch entries
+     * @param first_region Region of batch entry 0 of this output
+     * @param boxes Receives the detected boxes in original image coordinates
+     * @param scores Receives the confidence of each box
+     */
+    void postprocess(const float* output_data, size_t num_detected, const std::vector<InferenceRegion>& regions,
+                     size_t first_region, std::vector<cv::Rect>& boxes, std::vector<float>& scores);
 
     Ort::Env env; /**< ONNX runtime environment */
     Ort::Session session{nullptr}; /**< ONNX runtime session */
@@ -85,9 +196,19 @@ private:
     std::vector<const char*> output_node_names; /**< Names of output nodes */
 
     std::vector<int64_t> input_node_dims; /**< Dimensions of input nodes */
+    std::vector<int64_t> output_node_dims; /**< Dimensions of the output node, negative where dynamic */
+    int fixed_batch_size = 1; /**< Batch size of the model input, 0 if dynamic */
+    bool dynamic_input_size = false; /**< Spatial input dimensions are dynamic */
+    InputTensorFormat input_format; /**< Element type and layout of the model input */
 
     Ort::SessionOptions session_options; /**< ONNX runtime session options */
     Ort::MemoryInfo memory_info{ nullptr }; /**< ONNX runtime memory info */
+
+    std::once_flag executor_once; /**< Creates executor on the first asynchronous detection */
+    std::unique_ptr<WorkStealingPool> executor; /**< Threads running asynchronous detections */
+
+    std::mutex context_mutex; /**< Guards idle_contexts */
+    std::vector<std::unique_ptr<BindingContext>> idle_contexts; /**< Binding contexts not in use */
 };
 
 #endif // ONNX_MODEL_H
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "pipeline.h"
+#include "logger.h"
+#include <chrono>
+
+Pipeline::Pipeline(ThreadSafeQueue<Frame>& input, ThreadSafeQueue<Frame>& output, size_t workers, size_t maxInFlight)
+    : input(input), output(output), pool(std::make_unique<WorkStealingPool>(workers)),
+      maxInFlight(maxInFlight > 0 ? maxInFlight : 2 * pool->size()) {
+    LOG_INFO("Pipeline: %zu workers, up to %zu frames in flight", pool->size(), this->maxInFlight);
+}
+
+Pipeline::~Pipeline() {
+    finish();
+}
+
+void Pipeline::addStage(const std::string& name, StageMode mode, StageFunction function) {
+    auto stage = std::make_unique<Stage>();
+    stage->name = name;
+    stage->mode = mode;
+    stage->function = std::move(function);
+    stages.push_back(std::move(stage));
+}
+
+void Pipeline::run(const std::atomic<bool>& stop) {
+    Frame frame;
+    while (!stop && input.pop(frame)) {
+        if (!frame.original.empty()) {
+            submit(std::move(frame));
+        }
+    }
+    finish();
+}
+
+void Pipeline::submit(Frame&& frame) {
+    {
+        std::unique_lock<std::mutex> lock(flightMutex);
+        flightChanged.wait(lock, [this] { return inFlight < maxInFlight; });
+        inFlight++;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->frame = std::move(frame);
+    job->sequence = nextSequence++;
+    schedule(0, std::move(job));
+}
+
+void Pipeline::finish() {
+    if (finished) return;
+    finished = true;
+
+    {
+        std::unique_lock<std::mutex> lock(flightMutex);
+        flightChanged.wait(lock, [this] { return inFlight == 0; });
+    }
+    pool->stop();
+
+    LOG_INFO("Pipeline stage times (%llu tasks stolen):", static_cast<unsigned long long>(pool->stolen()));
+    for (const auto& stage : stages) {
+        long long frames = stage->frames.load();
+        LOG_INFO("   %s (%s): %.2f ms avg over %lld frames", stage->name.c_str(),
+                 stage->mode == StageMode::SERIAL ? "serial" : "parallel",
+                 frames > 0 ? stage->busyTime.load() / 1e6 / frames : 0.0, frames);
+    }
+}
+
+void Pipeline::schedule(size_t index, std::shared_ptr<Job> job) {
+    pool->submit([this, index, job]() mutable { runStage(index, std::move(job)); });
+}
+
+void Pipeline::execute(Stage& stage, Frame& frame) {
+    auto start = std::chrono::steady_clock::now();
+    stage.function(frame);
+    auto end = std::chrono::steady_clock::now();
+    stage.busyTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    stage.frames++;
+}
+
+void Pipeline::runStage(size_t index, std::shared_ptr<Job> job) {
+    if (index == stages.size()) {
+        output.push(std::move(job->frame));
+        {
+            std::lock_guard<std::mutex> lock(flightMutex);
+            inFlight--;
+        }
+        flightChanged.notify_all();
+        return;
+    }
+
+    Stage& stage = *stages[index];
+    if (stage.mode == StageMode::PARALLEL) {
+        execute(stage, job->frame);
+        schedule(index + 1, std::move(job));
+        return;
+    }
+
+    // Serial stages run frames in input order; whoever finds the stage idle drains it
+    std::unique_lock<std::mutex> lock(stage.mutex);
+    uint64_t sequence = job->sequence;
+    stage.pending.emplace(sequence, std::move(job));
+    if (stage.draining) return;
+    stage.draining = true;
+
+    while (!stage.pending.empty() && stage.pending.begin()->first == stage.nextSequence) {
+        std::shared_ptr<Job> next = std::move(stage.pending.begin()->second);
+        stage.pending.erase(stage.pending.begin());
+        lock.unlock();
+
+        execute(stage, next->frame);
+        schedule(index + 1, std::move(next));
+
+        lock.lock();
+        stage.nextSequence++;
+    }
+    stage.draining = false;
+}
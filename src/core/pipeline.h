@@ -0,0 +1,130 @@
+/**
+ * @file pipeline.h
+ * @brief Defines the Pipeline class, which runs frames through a graph of stage tasks on a work-stealing pool
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "frame.h"
+#include "thread_safe_queue.h"
+#include "work_stealing_pool.h"
+
+/**
+ * @class Pipeline
+ * @brief Frame pipeline built from stage tasks instead of dedicated stage threads
+ *
+ * Stages are declared in order with addStage(). Every frame taken from the input
+ * queue becomes a unit of work that runs each stage as a task on a shared
+ * WorkStealingPool, so any idle core picks up whichever stage is behind.
+ *
+ * PARALLEL stages must be stateless and run for several frames at once. SERIAL
+ * stages keep state across frames; they see one frame at a time, in the order
+ * the frames were taken from the input queue, and buffer frames that arrive
+ * early from the parallel stages before them. Frames leave the last stage into
+ * the output queue; the number of frames in flight is bounded.
+ */
+class Pipeline {
+public:
+    /**
+     * @enum StageMode
+     * @brief How a stage may run across frames
+     */
+    enum class StageMode {
+        PARALLEL,   /**< Stateless, any number of frames at once */
+        SERIAL      /**< Stateful, one frame at a time in stream order */
+    };
+
+    using StageFunction = std::function<void(Frame&)>;
+
+    /**
+     * @brief Constructor for the Pipeline class
+     * @param input Queue the frames are taken from
+     * @param output Queue the finished frames are pushed to
+     * @param workers Number of worker threads, 0 for one per hardware thread
+     * @param maxInFlight Maximum frames between input and output, 0 for twice the worker count
+     */
+    Pipeline(ThreadSafeQueue<Frame>& input, ThreadSafeQueue<Frame>& output, size_t workers = 0, size_t maxInFlight = 0);
+
+    /**
+     * @brief Destructor, waits for the frames in flight
+     */
+    ~Pipeline();
+
+    /**
+     * @brief Append a stage to the graph; must be called before the first frame is submitted
+     * @param name Stage name for logging
+     * @param mode Whether the stage may run for several frames at once
+     * @param function Work done on a frame
+     */
+    void addStage(const std::string& name, StageMode mode, StageFunction function);
+
+    /**
+     * @brief Move frames from the input queue into the pipeline until stopped, then drain it
+     * @param stop Flag ending the intake loop; close the input queue to wake it up
+     */
+    void run(const std::atomic<bool>& stop);
+
+    /**
+     * @brief Start one frame through the stages, blocking while too many frames are in flight
+     * @param frame Frame to process
+     */
+    void submit(Frame&& frame);
+
+    /**
+     * @brief Wait for the frames in flight, log the stage times and stop the workers
+     */
+    void finish();
+
+private:
+    struct Job {
+        Frame frame;
+        uint64_t sequence = 0;   ///< Position in the input order
+    };
+
+    struct Stage {
+        std::string name;
+        StageMode mode = StageMode::PARALLEL;
+        StageFunction function;
+        std::mutex mutex;                                    ///< Guards the fields below (SERIAL only)
+        std::map<uint64_t, std::shared_ptr<Job>> pending;    ///< Frames waiting for their turn
+        uint64_t nextSequence = 0;                           ///< Sequence the stage runs next
+        bool draining = false;                               ///< A task is running the pending frames
+        std::atomic<long long> busyTime{0};                  ///< Nanoseconds spent in function
+        std::atomic<long long> frames{0};                    ///< Frames processed
+    };
+
+    /**
+     * @brief Run stage index for a job, or hand it to the output after the last stage
+     */
+    void runStage(size_t index, std::shared_ptr<Job> job);
+
+    /**
+     * @brief Time one call of a stage function
+     */
+    void execute(Stage& stage, Frame& frame);
+
+    /**
+     * @brief Queue the next stage of a job on the pool
+     */
+    void schedule(size_t index, std::shared_ptr<Job> job);
+
+    ThreadSafeQueue<Frame>& input;                 ///< Frames to process
+    ThreadSafeQueue<Frame>& output;                ///< Finished frames
+    std::vector<std::unique_ptr<Stage>> stages;    ///< Stage graph, in order
+    std::unique_ptr<WorkStealingPool> pool;        ///< Workers running the stage tasks
+    size_t maxInFlight;                            ///< Bound on frames between input and output
+    uint64_t nextSequence = 0;                     ///< Sequence of the next submitted frame
+    std::mutex flightMutex;                        ///< Guards inFlight
+    std::condition_variable flightChanged;         ///< Signalled when a frame leaves the pipeline
+    size_t inFlight = 0;                           ///< Frames submitted but not yet output
+    bool finished = false;                         ///< finish() has run
+};
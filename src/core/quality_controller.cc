@@ -0,0 +1,161 @@
+#include "quality_controller.h"
+#include "config.h"
+#include "logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Each resolution step shrinks the input by this factor, each tile step grows the tiles by its inverse
+constexpr double SCALE_STEP = 0.8;
+
+// YOLO-style models downsample by 32
+int roundTo32(double value) {
+    return std::max(32, static_cast<int>(std::lround(value / 32.0)) * 32);
+}
+
+} // namespace
+
+QualityController& QualityController::getInstance() {
+    static QualityController instance;
+    return instance;
+}
+
+std::vector<QualityController::Settings> QualityController::buildLadder(const Options& options) {
+    // Steps of every knob, from the configured value towards its limit
+    std::vector<int> intervals;
+    for (int interval = 2; interval <= options.maxDetectionInterval; ++interval) {
+        intervals.push_back(interval);
+    }
+
+    std::vector<cv::Size> sizes;
+    if (options.resizableInput) {
+        for (double scale = SCALE_STEP; scale >= options.minInputScale - 1e-9; scale *= SCALE_STEP) {
+            cv::Size size(roundTo32(options.inputSize.width * scale), roundTo32(options.inputSize.height * scale));
+            if (size != (sizes.empty() ? options.inputSize : sizes.back())) {
+                sizes.push_back(size);
+            }
+        }
+    }
+
+    std::vector<int> tileSizes;
+    if (options.tileSize > 0) {
+        for (double scale = 1.0 / SCALE_STEP; scale <= options.maxTileScale + 1e-9; scale /= SCALE_STEP) {
+            int tileSize = roundTo32(options.tileSize * scale);
+            if (tileSize != (tileSizes.empty() ? options.tileSize : tileSizes.back())) {
+                tileSizes.push_back(tileSize);
+            }
+        }
+    }
+
+    // Every level relaxes the next knob in turn that still has steps left
+    Settings settings;
+    settings.inputSize = options.inputSize;
+    settings.tileSize = options.tileSize;
+    std::vector<Settings> ladder{settings};
+
+    size_t nextInterval = 0, nextSize = 0, nextTile = 0;
+    for (bool advanced = true; advanced;) {
+        advanced = false;
+        if (nextInterval < intervals.size()) {
+            settings.detectionInterval = intervals[nextInterval++];
+            ladder.push_back(settings);
+            advanced = true;
+        }
+        if (nextSize < sizes.size()) {
+            settings.inputSize = sizes[nextSize++];
+            ladder.push_back(settings);
+            advanced = true;
+        }
+        if (nextTile < tileSizes.size()) {
+            settings.tileSize = tileSizes[nextTile++];
+            ladder.push_back(settings);
+            advanced = true;
+        }
+    }
+    return ladder;
+}
+
+void QualityController::configure(const Options& options) {
+    this->options = options;
+    ladder = buildLadder(options);
+    level = 0;
+    overBudgetWindows = 0;
+    headroomWindows = 0;
+    holdWindows = 0;
+
+    LOG_INFO("Quality controller: target %.1f FPS, %zu quality levels", options.targetFPS, ladder.size());
+    if (options.latencyBudgetMs > 0) {
+        LOG_INFO("   Latency budget %.0f ms", options.latencyBudgetMs);
+    }
+    if (!options.resizableInput) {
+        LOG_INFO("   Model input size is fixed, resolution stays at %dx%d",
+                 options.inputSize.width, options.inputSize.height);
+    }
+}
+
+bool QualityController::update(const Measurement& measurement) {
+    if (ladder.empty()) return false;
+
+    // Let the last change show up in the measurements first
+    if (holdWindows > 0) {
+        holdWindows--;
+        return false;
+    }
+
+    double margin = options.margin;
+    double load = measurement.stageMs * options.targetFPS / 1000.0;
+    bool latencyOver = options.latencyBudgetMs > 0 && measurement.latencyMs > options.latencyBudgetMs * (1.0 + margin);
+    bool latencyClear = options.latencyBudgetMs <= 0 || measurement.latencyMs < options.latencyBudgetMs * (1.0 - margin);
+
+    // A slow source lowers the frame rate too; only react when the pipeline is the bottleneck
+    bool overBudget = latencyOver ||
+                      (measurement.fps < options.targetFPS * (1.0 - margin) &&
+                       (load > 1.0 - margin || measurement.queueDepth > 1));
+    bool headroom = !overBudget && latencyClear && load < 1.0 - 2.0 * margin && measurement.queueDepth == 0;
+
+    overBudgetWindows = overBudget ? overBudgetWindows + 1 : 0;
+    headroomWindows = headroom ? headroomWindows + 1 : 0;
+
+    int previous = level.load();
+    int next = previous;
+    if (overBudgetWindows >= options.windows && previous + 1 < static_cast<int>(ladder.size())) {
+        next = previous + 1;
+    } else if (headroomWindows >= 2 * options.windows && previous > 0) {
+        next = previous - 1;
+    }
+    if (next == previous) return false;
+
+    level = next;
+    overBudgetWindows = 0;
+    headroomWindows = 0;
+    holdWindows = options.windows;
+
+    const Settings& settings = ladder[next];
+    LOG_INFO("[Quality] %s quality to level %d/%d: detect every %d frames, input %dx%d, tiles %d px "
+             "(%.1f FPS, latency %.1f ms, busiest stage %.1f ms, %zu queued)",
+             next > previous ? "Lowered" : "Raised", next, static_cast<int>(ladder.size()) - 1,
+             settings.detectionInterval, settings.inputSize.width, settings.inputSize.height, settings.tileSize,
+             measurement.fps, measurement.latencyMs, measurement.stageMs, measurement.queueDepth);
+    return true;
+}
+
+QualityController::Settings QualityController::current() const {
+    if (ladder.empty()) {
+        Settings settings;
+        settings.inputSize = cv::Size(Config::getInputWidth(), Config::getInputHeight());
+        settings.tileSize = Config::getTileSize();
+        return settings;
+    }
+    return ladder[level.load()];
+}
+
+std::vector<int64_t> QualityController::inputDims(const std::vector<int64_t>& modelDims) const {
+    std::vector<int64_t> dims = modelDims;
+    if (!ladder.empty() && dims.size() == 4) {
+        cv::Size size = ladder[level.load()].inputSize;
+        dims[2] = size.height;
+        dims[3] = size.width;
+    }
+    return dims;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file quality_controller.h
+ * @brief Defines the QualityController class, which trades detection quality for throughput at runtime
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class QualityController
+ * @brief Closed-loop controller holding a target frame rate or latency budget
+ *
+ * Once per measurement window the display loop reports the shown frame rate,
+ * the glass-to-glass latency, the time per frame of the busiest stage and the
+ * number of frames queued between stages. The controller moves along a ladder
+ * of quality levels; level 0 is the configured quality and every further level
+ * relaxes one knob of the level before it, cycling through the detection
+ * interval, the model input resolution (models with dynamic input size only)
+ * and the tile size (fewer tiles).
+ *
+ * Hysteresis keeps it from oscillating: a level is given up after `windows`
+ * consecutive windows over budget, but only regained after twice as many
+ * windows in which the busiest stage leaves a clear margin, and every change is
+ * followed by a hold of `windows` windows so its effect shows up in the
+ * measurements first.
+ *
+ * The ladder is built by configure() before the pipeline starts; afterwards only
+ * the level changes, so the stage threads read the settings without locking.
+ */
+class QualityController {
+public:
+    /**
+     * @struct Settings
+     * @brief Knob values of one quality level
+     */
+    struct Settings {
+        int detectionInterval = 1;   ///< Inference runs on every Nth frame, the others reuse its detections
+        cv::Size inputSize;          ///< Model input resolution
+        int tileSize = 0;            ///< Tile side length when tiling is enabled
+    };
+
+    /**
+     * @struct Options
+     * @brief Targets and limits of the controller
+     */
+    struct Options {
+        double targetFPS = 15.0;           ///< Frame rate to hold
+        double latencyBudgetMs = 0.0;      ///< Glass-to-glass latency to stay under, 0 for none
+        double margin = 0.1;               ///< Relative dead band around the targets
+        int windows = 3;                   ///< Consecutive windows over budget before stepping down
+        int maxDetectionInterval = 3;      ///< Largest detection interval
+        double minInputScale = 0.5;        ///< Smallest input resolution relative to inputSize
+        double maxTileScale = 2.0;         ///< Largest tile size relative to tileSize
+        cv::Size inputSize;                ///< Configured model input resolution
+        bool resizableInput = false;       ///< The model accepts other input resolutions
+        int tileSize = 0;                  ///< Configured tile size, 0 if tiling is disabled
+    };
+
+    /**
+     * @struct Measurement
+     * @brief Pipeline behaviour over one measurement window
+     */
+    struct Measurement {
+        double fps = 0.0;            ///< Frames shown per second
+        double latencyMs = 0.0;      ///< Mean glass-to-glass latency
+        double stageMs = 0.0;        ///< Mean time per frame of the busiest stage
+        size_t queueDepth = 0;       ///< Frames waiting between stages at the end of the window
+    };
+
+    /**
+     * @brief Get the singleton instance of QualityController
+     * @return Reference to the QualityController instance
+     */
+    static QualityController& getInstance();
+
+    /**
+     * @brief Build the quality ladder and enable the controller
+     * @param options Targets and limits
+     */
+    void configure(const Options& options);
+
+    /**
+     * @brief Check whether the controller has been configured
+     * @return true if the settings follow the controller
+     */
+    bool isEnabled() const { return !ladder.empty(); }
+
+    /**
+     * @brief Feed the measurements of one window and adjust the level if needed
+     * @param measurement Measurements of the window that just ended
+     * @return true if the level changed
+     */
+    bool update(const Measurement& measurement);
+
+    /**
+     * @brief Get the knob values of the current level
+     * @return Current settings; the configured values while the controller is disabled
+     */
+    Settings current() const;
+
+    /**
+     * @brief Get the model input dimensions for the current level
+     * @param modelDims Input node dimensions of the loaded model (NCHW)
+     * @return modelDims with the spatial dimensions of the current input resolution
+     */
+    std::vector<int64_t> inputDims(const std::vector<int64_t>& modelDims) const;
+
+    /**
+     * @brief Get the current quality level
+     * @return 0 for the configured quality, higher for cheaper settings
+     */
+    int getLevel() const { return level.load(); }
+
+    /**
+     * @brief Get the number of quality levels
+     * @return Ladder length, 0 while the controller is disabled
+     */
+    int getLevelCount() const { return static_cast<int>(ladder.size()); }
+
+    /**
+     * @brief Build the quality ladder for a set of options
+     * @param options Targets and limits
+     * @return Settings of every level, starting with the configured quality
+     */
+    static std::vector<Settings> buildLadder(const Options& options);
+
+private:
+    QualityController() = default;
+    QualityController(const QualityController&) = delete;
+    QualityController& operator=(const QualityController&) = delete;
+
+    Options options;                      ///< Targets and limits
+    std::vector<Settings> ladder;         ///< Settings of every level, immutable once configured
+    std::atomic<int> level{0};            ///< Current index into ladder
+    int overBudgetWindows = 0;            ///< Consecutive windows over budget
+    int headroomWindows = 0;              ///< Consecutive windows with spare capacity
+    int holdWindows = 0;                  ///< Windows left before the next change is allowed
+};
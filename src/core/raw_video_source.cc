@@ -0,0 +1,146 @@
+#include "raw_video_source.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+RawVideoSource::RawVideoSource(const std::string& path, Format format, cv::Size size, double fps)
+    : path(path), format(format), size(size), fps(fps) {
+}
+
+bool RawVideoSource::parseFormat(const std::string& name, Format& format) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c){ return std::tolower(c); });
+    if (lower == "y4m") format = Format::Y4M;
+    else if (lower == "bgr") format = Format::BGR;
+    else if (lower == "nv12") format = Format::NV12;
+    else return false;
+    return true;
+}
+
+bool RawVideoSource::open() {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open raw video %s", path.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        LOG_ERROR("Raw video %s is empty", path.c_str());
+        ::close(fd);
+        return false;
+    }
+    mappingSize = static_cast<size_t>(st.st_size);
+
+    // Private and writable: consumers may draw on views without touching the file
+    void* data = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map raw video %s", path.c_str());
+        return false;
+    }
+    madvise(data, mappingSize, MADV_SEQUENTIAL);
+
+    size_t length = mappingSize;
+    mapping = std::shared_ptr<uint8_t>(static_cast<uint8_t*>(data),
+                                       [length](uint8_t* p) { munmap(p, length); });
+
+    frameOffsets.clear();
+    nextFrame = 0;
+
+    if (format == Format::Y4M) {
+        if (!indexY4M()) return false;
+    } else {
+        if (size.width <= 0 || size.height <= 0) {
+            LOG_ERROR("Raw video %s needs a frame size", path.c_str());
+            return false;
+        }
+        size_t frameBytes = format == Format::BGR ? size.area() * 3 : size.area() * 3 / 2;
+        for (size_t offset = 0; offset + frameBytes <= mappingSize; offset += frameBytes) {
+            frameOffsets.push_back(offset);
+        }
+    }
+
+    LOG_INFO("Raw video mapped: %zu frames of %dx%d at %.2f FPS",
+             frameOffsets.size(), size.width, size.height, fps);
+    return !frameOffsets.empty();
+}
+
+bool RawVideoSource::indexY4M() {
+    const char* base = reinterpret_cast<const char*>(mapping.get());
+    const char* end = base + mappingSize;
+    const char* headerEnd = static_cast<const char*>(memchr(base, '\n', mappingSize));
+
+    if (mappingSize < 10 || std::strncmp(base, "YUV4MPEG2 ", 10) != 0 || !headerEnd) {
+        LOG_ERROR("%s is not a YUV4MPEG2 file", path.c_str());
+        return false;
+    }
+
+    std::istringstream header(std::string(base + 10, headerEnd));
+    std::string token;
+    std::string colorspace = "420jpeg";
+    while (header >> token) {
+        switch (token[0]) {
+            case 'W': size.width = std::stoi(token.substr(1)); break;
+            case 'H': size.height = std::stoi(token.substr(1)); break;
+            case 'C': colorspace = token.substr(1); break;
+            case 'F': {
+                size_t colon = token.find(':');
+                if (colon != std::string::npos) {
+                    double den = std::stod(token.substr(colon + 1));
+                    fps = den > 0 ? std::stod(token.substr(1, colon - 1)) / den : fps;
+                }
+                break;
+            }
+        }
+    }
+
+    monochrome = colorspace == "mono";
+    if (!monochrome && colorspace.compare(0, 3, "420") != 0) {
+        LOG_ERROR("Unsupported Y4M colorspace C%s, only 4:2:0 and mono are supported", colorspace.c_str());
+        return false;
+    }
+    if (size.width <= 0 || size.height <= 0 || (!monochrome && (size.width % 2 || size.height % 2))) {
+        LOG_ERROR("Invalid Y4M frame size %dx%d", size.width, size.height);
+        return false;
+    }
+
+    size_t frameBytes = monochrome ? size.area() : size.area() * 3 / 2;
+    const char* cursor = headerEnd + 1;
+    while (cursor + 5 <= end && std::strncmp(cursor, "FRAME", 5) == 0) {
+        const char* dataStart = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+        if (!dataStart || static_cast<size_t>(end - dataStart - 1) < frameBytes) break;
+        frameOffsets.push_back(dataStart + 1 - base);
+        cursor = dataStart + 1 + frameBytes;
+    }
+
+    return true;
+}
+
+bool RawVideoSource::getNextFrame(Frame& frame) {
+    if (!mapping || nextFrame >= frameOffsets.size()) {
+        return false;
+    }
+
+    uint8_t* data = mapping.get() + frameOffsets[nextFrame++];
+
+    if (format == Format::BGR) {
+        // Zero-copy view over the mapping
+        frame.original = cv::Mat(size, CV_8UC3, data);
+    } else if (monochrome) {
+        cv::cvtColor(cv::Mat(size, CV_8UC1, data), frame.original, cv::COLOR_GRAY2BGR);
+    } else {
+        cv::Mat yuv(size.height * 3 / 2, size.width, CV_8UC1, data);
+        cv::cvtColor(yuv, frame.original,
+                     format == Format::NV12 ? cv::COLOR_YUV2BGR_NV12 : cv::COLOR_YUV2BGR_I420);
+    }
+
+    // Keep the mapping alive for as long as the frame may refer to it
+    frame.sourceLease = mapping;
+    return true;
+}
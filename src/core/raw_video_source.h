@@ -0,0 +1,95 @@
+/**
+ * @file raw_video_source.h
+ * @brief Defines the RawVideoSource class for memory-mapped uncompressed video
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "frame.h"
+
+/**
+ * @class RawVideoSource
+ * @brief Serves frames straight out of a memory-mapped Y4M or headerless raw file
+ *
+ * BGR frames are handed out as cv::Mat views over the mapping without any copy.
+ * YUV frames (NV12 and Y4M 4:2:0) still need a color conversion to BGR, which
+ * is cheap next to codec decode. The mapping is private and writable, so a
+ * consumer drawing on a view gets copy-on-write pages instead of modifying the
+ * file. Each frame holds a reference to the mapping, which stays alive until
+ * both the source and all frames are gone.
+ */
+class RawVideoSource {
+public:
+    /**
+     * @enum Format
+     * @brief Layout of the file
+     */
+    enum class Format {
+        Y4M,   /**< YUV4MPEG2 with 4:2:0 or mono frames; size and rate come from the header */
+        BGR,   /**< Headerless packed 8-bit BGR frames */
+        NV12   /**< Headerless NV12 frames */
+    };
+
+    /**
+     * @brief Constructor for the RawVideoSource class
+     * @param path File to map
+     * @param format Layout of the file
+     * @param size Frame size, ignored for Y4M
+     * @param fps Frame rate, ignored for Y4M
+     */
+    RawVideoSource(const std::string& path, Format format, cv::Size size, double fps);
+
+    /**
+     * @brief Map the file and index its frames
+     * @return false if the file cannot be mapped or is malformed
+     */
+    bool open();
+
+    /**
+     * @brief Get the next frame
+     * @param frame Receives the frame in Frame::original
+     * @return false at the end of the file
+     */
+    bool getNextFrame(Frame& frame);
+
+    /**
+     * @brief Get the frame rate of the stream
+     * @return Frames per second
+     */
+    double getFrameRate() const { return fps; }
+
+    /**
+     * @brief Get the number of frames in the file
+     * @return Number of frames
+     */
+    size_t frameCount() const { return frameOffsets.size(); }
+
+    /**
+     * @brief Parse a format name as used in the configuration file
+     * @param name "y4m", "bgr" or "nv12" (case-insensitive)
+     * @param format Receives the parsed format
+     * @return false for unknown names
+     */
+    static bool parseFormat(const std::string& name, Format& format);
+
+private:
+    /**
+     * @brief Parse the Y4M stream header and locate all frames
+     */
+    bool indexY4M();
+
+    std::string path;                      ///< Mapped file
+    Format format;                         ///< Layout of the file
+    cv::Size size;                         ///< Frame size
+    double fps;                            ///< Frame rate
+    bool monochrome = false;               ///< Y4M stream has no chroma planes
+    std::shared_ptr<uint8_t> mapping;      ///< Mapped file, unmapped by the last owner
+    size_t mappingSize = 0;                ///< Length of the mapping
+    std::vector<size_t> frameOffsets;      ///< Offset of each frame's pixel data
+    size_t nextFrame = 0;                  ///< Index of the next frame to return
+};
@@ -0,0 +1,165 @@
+#include "reid_model.h"
+#include "logger.h"
+#include <opencv2/dnn/dnn.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// ImageNet statistics the common re-identification backbones are trained with, RGB order
+const float MEAN[3] = {0.485f, 0.456f, 0.406f};
+const float STD[3] = {0.229f, 0.224f, 0.225f};
+
+} // namespace
+
+void EmbeddingGallery::add(std::vector<float> embedding) {
+    if (capacity == 0) return;
+    if (embeddings.size() < capacity) {
+        embeddings.push_back(std::move(embedding));
+    } else {
+        embeddings[next] = std::move(embedding);
+        next = (next + 1) % capacity;
+    }
+}
+
+float EmbeddingGallery::distance(const std::vector<float>& embedding) const {
+    float best = 2.0f;
+    for (const auto& stored : embeddings) {
+        best = std::min(best, cosineDistance(stored, embedding));
+    }
+    return best;
+}
+
+float EmbeddingGallery::cosineDistance(const std::vector<float>& a, const std::vector<float>& b) {
+    if (a.size() != b.size() || a.empty()) return 2.0f;
+    float dot = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i) {
+        dot += a[i] * b[i];
+    }
+    return std::clamp(1.0f - dot, 0.0f, 2.0f);
+}
+
+ReIDModel::ReIDModel() : env(ORT_LOGGING_LEVEL_WARNING, "ReIDModel") {}
+
+ReIDModel& ReIDModel::getInstance() {
+    static ReIDModel instance;
+    return instance;
+}
+
+bool ReIDModel::loadModel(const std::string& model_path) {
+    try {
+        // Small model next to the detector, keep it off most cores
+        session_options.SetIntraOpNumThreads(1);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        session = Ort::Session(env, model_path.c_str(), session_options);
+        memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name = session.GetInputNameAllocated(0, allocator).get();
+        output_name = session.GetOutputNameAllocated(0, allocator).get();
+
+        std::vector<int64_t> shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (shape.size() != 4) {
+            LOG_ERROR("Re-identification model input must be NCHW, got %zu dimensions", shape.size());
+            return false;
+        }
+        if (shape[2] > 0 && shape[3] > 0) {
+            input_size = cv::Size(static_cast<int>(shape[3]), static_cast<int>(shape[2]));
+        }
+        fixed_batch_size = shape[0] > 0 ? static_cast<int>(shape[0]) : 0;
+
+        loaded = true;
+        LOG_INFO("Re-identification model loaded with %dx%d input, batch size %s", input_size.width, input_size.height,
+                 fixed_batch_size == 0 ? "dynamic" : std::to_string(fixed_batch_size).c_str());
+        return true;
+    } catch (const Ort::Exception& e) {
+        LOG_ERROR("Error loading re-identification model: %s", e.what());
+        return false;
+    }
+}
+
+std::vector<std::vector<float>> ReIDModel::embed(const cv::Mat& image, const std::vector<cv::Rect>& boxes) {
+    std::vector<std::vector<float>> result(boxes.size());
+    if (!loaded || boxes.empty()) return result;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    cv::Rect bounds(cv::Point(0, 0), image.size());
+    std::vector<size_t> indices;
+    std::vector<cv::Mat> crops;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        cv::Rect box = boxes[i] & bounds;
+        if (box.area() > 0) {
+            indices.push_back(i);
+            crops.push_back(image(box));
+        }
+    }
+
+    // Everything in one call unless the model was exported with a fixed batch size
+    size_t slice = fixed_batch_size > 0 ? static_cast<size_t>(fixed_batch_size) : crops.size();
+    std::vector<std::vector<float>> embeddings;
+    for (size_t first = 0; first < crops.size(); first += slice) {
+        size_t count = std::min(slice, crops.size() - first);
+        std::vector<cv::Mat> batch(crops.begin() + first, crops.begin() + first + count);
+        while (batch.size() < slice) {
+            batch.push_back(batch.back());  // Pad a fixed-size batch, the extra rows are dropped
+        }
+        if (!runBatch(batch, count, embeddings)) {
+            return result;
+        }
+    }
+
+    for (size_t i = 0; i < indices.size(); ++i) {
+        result[indices[i]] = std::move(embeddings[i]);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    LOG_DEBUG("[ReIDModel] Embedded %zu crops in %lld µs", crops.size(),
+              static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()));
+    return result;
+}
+
+bool ReIDModel::runBatch(std::vector<cv::Mat>& crops, size_t count, std::vector<std::vector<float>>& embeddings) {
+    cv::Mat blob = cv::dnn::blobFromImages(crops, 1.0 / 255.0, input_size, cv::Scalar(0, 0, 0), true, false);
+
+    // Normalize each RGB plane in place
+    size_t plane = static_cast<size_t>(input_size.area());
+    float* data = reinterpret_cast<float*>(blob.data);
+    for (size_t n = 0; n < crops.size(); ++n) {
+        for (int c = 0; c < 3; ++c) {
+            float* channel = data + (n * 3 + c) * plane;
+            for (size_t i = 0; i < plane; ++i) {
+                channel[i] = (channel[i] - MEAN[c]) / STD[c];
+            }
+        }
+    }
+
+    std::vector<int64_t> dims = {static_cast<int64_t>(crops.size()), 3, input_size.height, input_size.width};
+    Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, data, blob.total(), dims.data(), dims.size());
+
+    const char* input_names[] = {input_name.c_str()};
+    const char* output_names[] = {output_name.c_str()};
+    std::vector<Ort::Value> outputs;
+    try {
+        outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+    } catch (const Ort::Exception& e) {
+        LOG_ERROR("Error during re-identification: %s", e.what());
+        return false;
+    }
+
+    const float* output = outputs.front().GetTensorData<float>();
+    size_t dimension = outputs.front().GetTensorTypeAndShapeInfo().GetElementCount() / crops.size();
+    for (size_t n = 0; n < count; ++n) {
+        std::vector<float> embedding(output + n * dimension, output + (n + 1) * dimension);
+        float norm = 0.0f;
+        for (float value : embedding) norm += value * value;
+        norm = std::sqrt(norm);
+        if (norm > 0.0f) {
+            for (float& value : embedding) value /= norm;
+        }
+        embeddings.push_back(std::move(embedding));
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file reid_model.h
+ * @brief Defines the ReIDModel class, which computes appearance embeddings, and the per-track EmbeddingGallery
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <onnxruntime_cxx_api.h>
+
+/**
+ * @class EmbeddingGallery
+ * @brief Fixed number of recent appearance embeddings of one track
+ *
+ * New embeddings overwrite the oldest once the gallery is full, so a track
+ * remembers how it looked over its last few observations without growing.
+ */
+class EmbeddingGallery {
+public:
+    /**
+     * @brief Constructor for the EmbeddingGallery class
+     * @param capacity Number of embeddings kept
+     */
+    explicit EmbeddingGallery(size_t capacity = 0) : capacity(capacity) {}
+
+    /**
+     * @brief Store an embedding, replacing the oldest one if the gallery is full
+     * @param embedding L2-normalized embedding
+     */
+    void add(std::vector<float> embedding);
+
+    /**
+     * @brief Get the cosine distance to the closest stored embedding
+     * @param embedding L2-normalized embedding
+     * @return Distance in [0, 2], or 2 if the gallery is empty
+     */
+    float distance(const std::vector<float>& embedding) const;
+
+    /**
+     * @brief Check whether the gallery holds no embedding
+     * @return true if empty
+     */
+    bool empty() const { return embeddings.empty(); }
+
+    /**
+     * @brief Get the number of stored embeddings
+     * @return Embedding count, at most the capacity
+     */
+    size_t size() const { return embeddings.size(); }
+
+    /**
+     * @brief Cosine distance between two L2-normalized embeddings
+     */
+    static float cosineDistance(const std::vector<float>& a, const std::vector<float>& b);
+
+private:
+    size_t capacity;                            ///< Maximum number of embeddings
+    size_t next = 0;                            ///< Slot the next embedding overwrites once full
+    std::vector<std::vector<float>> embeddings; ///< Stored embeddings
+};
+
+/**
+ * @class ReIDModel
+ * @brief Singleton wrapping a small ONNX re-identification model
+ *
+ * The model maps a person or object crop to an appearance embedding. All crops
+ * of a frame go through the model as one batch.
+ */
+class ReIDModel {
+public:
+    /**
+     * @brief Get the singleton instance of ReIDModel
+     * @return Reference to the ReIDModel instance
+     */
+    static ReIDModel& getInstance();
+
+    /**
+     * @brief Load a re-identification model from a file
+     * @param model_path Path to the ONNX model file
+     * @return true if the model was successfully loaded, false otherwise
+     */
+    bool loadModel(const std::string& model_path);
+
+    /**
+     * @brief Check whether a model is loaded
+     * @return true after a successful loadModel()
+     */
+    bool isLoaded() const { return loaded; }
+
+    /**
+     * @brief Compute the embeddings of image areas in one batch
+     * @param image BGR image the boxes refer to
+     * @param boxes Areas to embed; clipped to the image
+     * @return One L2-normalized embedding per box, empty for boxes outside the image or on failure
+     */
+    std::vector<std::vector<float>> embed(const cv::Mat& image, const std::vector<cv::Rect>& boxes);
+
+private:
+    ReIDModel();
+    ~ReIDModel() = default;
+    ReIDModel(const ReIDModel&) = delete;
+    ReIDModel& operator=(const ReIDModel&) = delete;
+
+    /**
+     * @brief Run one batch of crops and append the normalized embeddings of the first count
+     */
+    bool runBatch(std::vector<cv::Mat>& crops, size_t count, std::vector<std::vector<float>>& embeddings);
+
+    Ort::Env env;                                  ///< ONNX runtime environment
+    Ort::Session session{nullptr};                 ///< ONNX runtime session
+    Ort::SessionOptions session_options;           ///< ONNX runtime session options
+    Ort::MemoryInfo memory_info{nullptr};          ///< ONNX runtime memory info
+    std::string input_name;                        ///< Name of the image input
+    std::string output_name;                       ///< Name of the embedding output
+    cv::Size input_size{128, 256};                 ///< Crop size the model expects
+    int fixed_batch_size = 0;                      ///< Batch size of the model input, 0 if dynamic
+    bool loaded = false;                           ///< A model is loaded
+};
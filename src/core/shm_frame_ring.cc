@@ -0,0 +1,224 @@
+#include "shm_frame_ring.h"
+#include "logger.h"
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "Atomics shared between processes must be lock-free");
+
+const size_t PAGE_SIZE = 4096;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t slotsOffset() {
+    return alignUp(sizeof(ShmRingHeader), alignof(ShmSlotHeader));
+}
+
+/**
+ * @brief Decrement a semaphore, waiting at most timeout
+ * @return false if the semaphore stayed zero
+ */
+bool waitFor(sem_t* semaphore, std::chrono::milliseconds timeout) {
+    if (timeout.count() <= 0) {
+        while (sem_trywait(semaphore) != 0) {
+            if (errno != EINTR) return false;
+        }
+        return true;
+    }
+
+    // sem_timedwait takes an absolute time on the realtime clock
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    long long nanoseconds = deadline.tv_nsec + static_cast<long long>(timeout.count()) * 1000000LL;
+    deadline.tv_sec += static_cast<time_t>(nanoseconds / 1000000000LL);
+    deadline.tv_nsec = static_cast<long>(nanoseconds % 1000000000LL);
+    while (sem_timedwait(semaphore, &deadline) != 0) {
+        if (errno != EINTR) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ShmFrameRing::ShmFrameRing(const std::string& name, uint8_t* base, size_t size, bool owner)
+    : name(name), base(base), size(size), owner(owner),
+      header(reinterpret_cast<ShmRingHeader*>(base)),
+      slots(reinterpret_cast<ShmSlotHeader*>(base + slotsOffset())) {
+}
+
+ShmFrameRing::~ShmFrameRing() {
+    if (owner) {
+        close();
+    }
+    munmap(base, size);
+    if (owner) {
+        shm_unlink(name.c_str());
+    }
+}
+
+std::unique_ptr<ShmFrameRing> ShmFrameRing::create(const std::string& name, uint32_t slotCount, size_t slotBytes,
+                                                   double fps) {
+    if (slotCount == 0 || slotBytes == 0) {
+        LOG_ERROR("Shared-memory ring %s needs at least one non-empty slot", name.c_str());
+        return nullptr;
+    }
+
+    size_t dataOffset = alignUp(slotsOffset() + slotCount * sizeof(ShmSlotHeader), PAGE_SIZE);
+    size_t dataStride = alignUp(slotBytes, PAGE_SIZE);
+    size_t size = dataOffset + slotCount * dataStride;
+
+    // A ring left behind by a crashed producer is replaced; a consumer still mapping it keeps its copy
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        LOG_ERROR("Failed to create shared memory %s: %s", name.c_str(), std::strerror(errno));
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        LOG_ERROR("Failed to size shared memory %s: %s", name.c_str(), std::strerror(errno));
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map shared memory %s: %s", name.c_str(), std::strerror(errno));
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    uint8_t* base = static_cast<uint8_t*>(data);
+    ShmRingHeader* header = new (base) ShmRingHeader();
+    header->version = VERSION;
+    header->slotCount = slotCount;
+    header->slotBytes = slotBytes;
+    header->dataOffset = dataOffset;
+    header->dataStride = dataStride;
+    header->fps = fps;
+    sem_init(&header->framesReady, 1, 0);
+    sem_init(&header->slotsFree, 1, slotCount);
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        new (base + slotsOffset() + i * sizeof(ShmSlotHeader)) ShmSlotHeader();
+    }
+
+    // Consumers check the magic first, so it is written once everything else is in place
+    reinterpret_cast<std::atomic<uint32_t>*>(&header->magic)->store(MAGIC, std::memory_order_release);
+
+    LOG_INFO("Shared-memory ring %s created: %u slots of %zu bytes", name.c_str(), slotCount, slotBytes);
+    return std::unique_ptr<ShmFrameRing>(new ShmFrameRing(name, base, size, true));
+}
+
+std::unique_ptr<ShmFrameRing> ShmFrameRing::attach(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return nullptr;  // The producer has not created the ring yet
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmRingHeader)) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map shared memory %s: %s", name.c_str(), std::strerror(errno));
+        return nullptr;
+    }
+
+    uint8_t* base = static_cast<uint8_t*>(data);
+    ShmRingHeader* header = reinterpret_cast<ShmRingHeader*>(base);
+    uint32_t magic = reinterpret_cast<std::atomic<uint32_t>*>(&header->magic)->load(std::memory_order_acquire);
+    if (magic != MAGIC || header->version != VERSION ||
+        size < header->dataOffset + static_cast<size_t>(header->slotCount) * header->dataStride) {
+        munmap(base, size);
+        return nullptr;
+    }
+
+    std::unique_ptr<ShmFrameRing> ring(new ShmFrameRing(name, base, size, false));
+    for (uint32_t i = 0; i < ring->slotCount(); ++i) {
+        uint32_t reading = READING;
+        if (ring->slots[i].state.compare_exchange_strong(reading, FREE, std::memory_order_acq_rel)) {
+            sem_post(&header->slotsFree);
+        }
+    }
+
+    LOG_INFO("Attached to shared-memory ring %s: %u slots of %zu bytes", name.c_str(), ring->slotCount(),
+             ring->slotBytes());
+    return ring;
+}
+
+int ShmFrameRing::beginWrite(std::chrono::milliseconds timeout) {
+    if (!waitFor(&header->slotsFree, timeout)) {
+        return -1;
+    }
+    // The semaphore counts free slots, so one is available
+    for (uint32_t i = 0; i < header->slotCount; ++i) {
+        uint32_t expected = FREE;
+        if (slots[i].state.compare_exchange_strong(expected, WRITING, std::memory_order_acquire)) {
+            return static_cast<int>(i);
+        }
+    }
+    sem_post(&header->slotsFree);
+    return -1;
+}
+
+void ShmFrameRing::publish(int slot, uint32_t width, uint32_t height, ShmPixelFormat format, uint32_t stride,
+                           int64_t timestampNs) {
+    ShmSlotHeader& target = slots[slot];
+    target.width = width;
+    target.height = height;
+    target.format = static_cast<uint32_t>(format);
+    target.stride = stride;
+    target.timestampNs = timestampNs;
+    target.sequence = header->published.load(std::memory_order_relaxed) + 1;
+    target.state.store(READY, std::memory_order_release);
+    header->published.store(target.sequence, std::memory_order_relaxed);
+    sem_post(&header->framesReady);
+}
+
+void ShmFrameRing::close() {
+    if (header->closed.exchange(1, std::memory_order_acq_rel) == 0) {
+        sem_post(&header->framesReady);  // Wake a consumer waiting for a frame that will not come
+    }
+}
+
+int ShmFrameRing::acquire(std::chrono::milliseconds timeout) {
+    if (!waitFor(&header->framesReady, timeout)) {
+        return -1;
+    }
+
+    // Frames may sit in any free slot the producer found, so take the oldest ready one
+    int oldest = -1;
+    uint64_t oldestSequence = 0;
+    for (uint32_t i = 0; i < header->slotCount; ++i) {
+        if (slots[i].state.load(std::memory_order_acquire) == READY &&
+            (oldest < 0 || slots[i].sequence < oldestSequence)) {
+            oldest = static_cast<int>(i);
+            oldestSequence = slots[i].sequence;
+        }
+    }
+    if (oldest < 0) {
+        // Woken by close(); keep the wakeup for later calls
+        sem_post(&header->framesReady);
+        return -1;
+    }
+    slots[oldest].state.store(READING, std::memory_order_relaxed);
+    return oldest;
+}
+
+void ShmFrameRing::release(int slot) {
+    slots[slot].state.store(FREE, std::memory_order_release);
+    sem_post(&header->slotsFree);
+}
@@ -0,0 +1,220 @@
+/**
+ * @file shm_frame_ring.h
+ * @brief Defines the ShmFrameRing class, a POSIX shared-memory ring of raw frames
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <semaphore.h>
+
+/**
+ * @enum ShmPixelFormat
+ * @brief Layout of the pixels in a slot
+ */
+enum class ShmPixelFormat : uint32_t {
+    BGR = 0,   /**< Packed 8-bit BGR */
+    NV12 = 1,  /**< Y plane followed by interleaved UV at half resolution */
+    GRAY = 2   /**< 8-bit luma only */
+};
+
+/**
+ * @struct ShmSlotHeader
+ * @brief Description of the frame held by one slot
+ *
+ * The producer fills the fields before marking the slot ready; they are constant
+ * while the consumer holds the slot.
+ */
+struct alignas(64) ShmSlotHeader {
+    std::atomic<uint32_t> state;  ///< One of ShmFrameRing::SlotState
+    uint32_t width;               ///< Frame width in pixels
+    uint32_t height;              ///< Frame height in pixels
+    uint32_t format;              ///< ShmPixelFormat of the pixels
+    uint32_t stride;              ///< Bytes per row of the first plane
+    uint64_t sequence;            ///< Position of the frame in the stream, starting at 1
+    int64_t timestampNs;          ///< Capture time on the steady (CLOCK_MONOTONIC) clock, 0 if unknown
+};
+
+/**
+ * @struct ShmRingHeader
+ * @brief Start of the shared-memory object; the slot headers and pixel areas follow
+ */
+struct alignas(64) ShmRingHeader {
+    uint32_t magic;                  ///< ShmFrameRing::MAGIC once the ring is initialized
+    uint32_t version;                ///< ShmFrameRing::VERSION
+    uint32_t slotCount;              ///< Number of slots
+    uint32_t reserved;
+    uint64_t slotBytes;              ///< Pixel capacity of each slot
+    uint64_t dataOffset;             ///< Offset of the first pixel area, page aligned
+    uint64_t dataStride;             ///< Distance between pixel areas, page aligned
+    double fps;                      ///< Nominal frame rate, 0 if unknown
+    std::atomic<uint64_t> published; ///< Frames published so far
+    std::atomic<uint64_t> dropped;   ///< Frames the producer dropped because no slot was free
+    std::atomic<uint32_t> closed;    ///< Nonzero once the producer ended the stream
+    sem_t framesReady;               ///< Counts ready slots, posted by the producer
+    sem_t slotsFree;                 ///< Counts free slots, posted by the consumer
+};
+
+/**
+ * @class ShmFrameRing
+ * @brief Ring of frame slots in POSIX shared memory, shared by one producer and one consumer process
+ *
+ * The producer takes a free slot, writes a frame into it and publishes it; the
+ * consumer acquires ready slots in sequence order, reads the pixels in place and
+ * releases each slot back to the producer when done. Slots move between states
+ * with atomics in the mapping, and two process-shared semaphores let either side
+ * sleep until the other hands over a slot. Frames are never overwritten while
+ * the consumer holds them: a producer that finds no free slot waits or drops the
+ * frame, so a slow consumer costs frames, not correctness.
+ */
+class ShmFrameRing {
+public:
+    static constexpr uint32_t MAGIC = 0x52465453;  ///< "STFR"
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * @enum SlotState
+     * @brief Ownership of a slot
+     */
+    enum SlotState : uint32_t {
+        FREE = 0,     /**< Available to the producer */
+        WRITING = 1,  /**< Being filled by the producer */
+        READY = 2,    /**< Published, waiting for the consumer */
+        READING = 3   /**< Held by the consumer */
+    };
+
+    /**
+     * @brief Create a ring as the producer, replacing a stale one of the same name
+     * @param name Shared-memory object name, starting with '/'
+     * @param slotCount Number of slots
+     * @param slotBytes Pixel capacity of each slot
+     * @param fps Nominal frame rate advertised to the consumer
+     * @return The ring, or null on failure
+     */
+    static std::unique_ptr<ShmFrameRing> create(const std::string& name, uint32_t slotCount, size_t slotBytes,
+                                                double fps);
+
+    /**
+     * @brief Attach to an existing ring as the consumer
+     *
+     * Slots a previous consumer still held are handed back to the producer.
+     * @param name Shared-memory object name used by the producer
+     * @return The ring, or null if it does not exist or is not a compatible ring
+     */
+    static std::unique_ptr<ShmFrameRing> attach(const std::string& name);
+
+    /**
+     * @brief Unmap the ring; the producer also removes the name
+     */
+    ~ShmFrameRing();
+
+    ShmFrameRing(const ShmFrameRing&) = delete;
+    ShmFrameRing& operator=(const ShmFrameRing&) = delete;
+
+    /**
+     * @brief Take a free slot to write a frame into (producer)
+     * @param timeout Time to wait for the consumer to release a slot, 0 to not wait
+     * @return Slot index, or -1 if no slot became free in time
+     */
+    int beginWrite(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Publish the frame written into a slot from beginWrite() (producer)
+     * @param slot Slot index
+     * @param width Frame width in pixels
+     * @param height Frame height in pixels
+     * @param format Layout of the pixels
+     * @param stride Bytes per row of the first plane
+     * @param timestampNs Capture time on the steady clock in nanoseconds, 0 if unknown
+     */
+    void publish(int slot, uint32_t width, uint32_t height, ShmPixelFormat format, uint32_t stride,
+                 int64_t timestampNs);
+
+    /**
+     * @brief Count a frame that was not published for lack of a free slot (producer)
+     */
+    void countDropped() { header->dropped.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief End the stream and wake the consumer (producer)
+     */
+    void close();
+
+    /**
+     * @brief Take the oldest ready slot (consumer)
+     * @param timeout Time to wait for a frame
+     * @return Slot index, or -1 on timeout or when the stream ended
+     */
+    int acquire(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Hand a slot from acquire() back to the producer (consumer)
+     * @param slot Slot index
+     */
+    void release(int slot);
+
+    /**
+     * @brief Get the description of the frame in a slot
+     * @param slot Slot index
+     * @return The slot header
+     */
+    const ShmSlotHeader& slot(int slot) const { return slots[slot]; }
+
+    /**
+     * @brief Get the pixel area of a slot
+     * @param slot Slot index
+     * @return First byte of the slot's pixels, slotBytes() long
+     */
+    uint8_t* data(int slot) const { return base + header->dataOffset + static_cast<size_t>(slot) * header->dataStride; }
+
+    /**
+     * @brief Check whether the producer ended the stream
+     * @return true once close() was called
+     */
+    bool isClosed() const { return header->closed.load(std::memory_order_acquire) != 0; }
+
+    /**
+     * @brief Get the number of slots
+     * @return Slot count
+     */
+    uint32_t slotCount() const { return header->slotCount; }
+
+    /**
+     * @brief Get the pixel capacity of a slot
+     * @return Bytes per slot
+     */
+    size_t slotBytes() const { return header->slotBytes; }
+
+    /**
+     * @brief Get the frame rate advertised by the producer
+     * @return Frames per second, or 0 if unknown
+     */
+    double fps() const { return header->fps; }
+
+    /**
+     * @brief Get the number of frames published so far
+     * @return Published frame count
+     */
+    uint64_t published() const { return header->published.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of frames the producer dropped for lack of a free slot
+     * @return Dropped frame count
+     */
+    uint64_t dropped() const { return header->dropped.load(std::memory_order_relaxed); }
+
+private:
+    ShmFrameRing(const std::string& name, uint8_t* base, size_t size, bool owner);
+
+    std::string name;           ///< Shared-memory object name
+    uint8_t* base;              ///< Start of the mapping
+    size_t size;                ///< Length of the mapping
+    bool owner;                 ///< Created by this process, which unlinks the name
+    ShmRingHeader* header;      ///< Ring header at the start of the mapping
+    ShmSlotHeader* slots;       ///< Slot headers following the ring header
+};
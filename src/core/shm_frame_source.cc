@@ -0,0 +1,78 @@
+#include "shm_frame_source.h"
+#include "logger.h"
+#include <thread>
+
+ShmFrameSource::ShmFrameSource(const std::string& name, std::chrono::milliseconds timeout)
+    : name(name), timeout(timeout) {
+}
+
+bool ShmFrameSource::open() {
+    // The capture process may start after us
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!(ring = ShmFrameRing::attach(name))) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            LOG_ERROR("No shared-memory frame ring %s within %lld ms", name.c_str(),
+                      static_cast<long long>(timeout.count()));
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return true;
+}
+
+bool ShmFrameSource::getNextFrame(Frame& frame) {
+    if (!ring) {
+        return false;
+    }
+
+    while (true) {
+        int slot = ring->acquire(timeout);
+        if (slot < 0) {
+            if (ring->isClosed()) {
+                LOG_INFO("Producer ended the stream after %llu frames, %llu dropped",
+                         static_cast<unsigned long long>(ring->published()),
+                         static_cast<unsigned long long>(ring->dropped()));
+            } else {
+                LOG_WARNING("No frame from %s within %lld ms", name.c_str(), static_cast<long long>(timeout.count()));
+            }
+            return false;
+        }
+
+        const ShmSlotHeader& header = ring->slot(slot);
+        cv::Size size(static_cast<int>(header.width), static_cast<int>(header.height));
+        ShmPixelFormat format = static_cast<ShmPixelFormat>(header.format);
+        size_t rows = format == ShmPixelFormat::NV12 ? static_cast<size_t>(size.height) * 3 / 2 : size.height;
+        size_t minStride = format == ShmPixelFormat::BGR ? static_cast<size_t>(size.width) * 3 : size.width;
+        if (size.area() <= 0 || header.stride < minStride || rows * header.stride > ring->slotBytes() ||
+            format > ShmPixelFormat::GRAY) {
+            LOG_ERROR("Skipping malformed frame %llu: %dx%d, format %u, stride %u",
+                      static_cast<unsigned long long>(header.sequence), size.width, size.height, header.format,
+                      header.stride);
+            ring->release(slot);
+            continue;
+        }
+
+        int64_t timestampNs = header.timestampNs;
+        uint8_t* data = ring->data(slot);
+        if (format == ShmPixelFormat::BGR) {
+            // Zero-copy view over the slot, returned to the producer with the last reference to the frame
+            frame.original = cv::Mat(size, CV_8UC3, data, header.stride);
+            std::shared_ptr<ShmFrameRing> owner = ring;
+            frame.sourceLease = std::shared_ptr<void>(data, [owner, slot](void*) { owner->release(slot); });
+        } else {
+            if (format == ShmPixelFormat::GRAY) {
+                cv::cvtColor(cv::Mat(size, CV_8UC1, data, header.stride), frame.original, cv::COLOR_GRAY2BGR);
+            } else {
+                cv::Mat nv12(size.height * 3 / 2, size.width, CV_8UC1, data, header.stride);
+                cv::cvtColor(nv12, frame.original, cv::COLOR_YUV2BGR_NV12);
+            }
+            frame.sourceLease.reset();
+            ring->release(slot);
+        }
+
+        frame.captureTime = timestampNs > 0
+            ? std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timestampNs))
+            : std::chrono::steady_clock::now();
+        return true;
+    }
+}
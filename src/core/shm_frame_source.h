@@ -0,0 +1,56 @@
+/**
+ * @file shm_frame_source.h
+ * @brief Defines the ShmFrameSource class for frames published by another process
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include "frame.h"
+#include "shm_frame_ring.h"
+
+/**
+ * @class ShmFrameSource
+ * @brief Reads frames from a shared-memory ring filled by an external capture process
+ *
+ * BGR frames are handed out as cv::Mat views over the slot without any copy; the
+ * frame's source lease returns the slot to the producer once the last copy of the
+ * frame is gone. NV12 and grayscale frames are converted to BGR and their slot is
+ * returned right away. The capture time is the producer's timestamp, so latency
+ * figures include the time a frame spent in the ring.
+ */
+class ShmFrameSource {
+public:
+    /**
+     * @brief Constructor for the ShmFrameSource class
+     * @param name Shared-memory object name of the ring
+     * @param timeout Time to wait for the producer, at attach and for each frame
+     */
+    ShmFrameSource(const std::string& name, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Attach to the ring, waiting for the producer to create it
+     * @return false if no ring appeared within the timeout
+     */
+    bool open();
+
+    /**
+     * @brief Get the next frame
+     * @param frame Receives the frame in Frame::original
+     * @return false when the producer ended the stream or sent nothing within the timeout
+     */
+    bool getNextFrame(Frame& frame);
+
+    /**
+     * @brief Get the frame rate advertised by the producer
+     * @return Frames per second, or 0 if unknown
+     */
+    double getFrameRate() const { return ring ? ring->fps() : 0.0; }
+
+private:
+    std::string name;                    ///< Shared-memory object name
+    std::chrono::milliseconds timeout;   ///< Time to wait for the producer
+    std::shared_ptr<ShmFrameRing> ring;  ///< Attached ring, kept alive by leased frames
+};
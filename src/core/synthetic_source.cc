@@ -0,0 +1,81 @@
+#include "synthetic_source.h"
+#include "logger.h"
+#include <algorithm>
+
+SyntheticSource::SyntheticSource(const SyntheticSourceOptions& options)
+    : options(options), framesProduced(0) {
+    reset();
+}
+
+float SyntheticSource::uniform(float lo, float hi) {
+    // std::uniform_real_distribution is implementation defined, mt19937 output is not
+    return lo + (hi - lo) * static_cast<float>(rng() / 4294967296.0);
+}
+
+void SyntheticSource::reset() {
+    rng.seed(options.seed);
+    objects.clear();
+    framesProduced = 0;
+
+    float minSide = std::min(options.width, options.height);
+    float maxSpeed = minSide / 120.0f;
+
+    for (int i = 0; i < options.numObjects; ++i) {
+        Object object;
+        object.id = i + 1;
+        object.size = cv::Size2f(uniform(0.05f, 0.2f) * minSide, uniform(0.05f, 0.2f) * minSide);
+        object.position = cv::Point2f(uniform(0.0f, options.width - object.size.width),
+                                      uniform(0.0f, options.height - object.size.height));
+        object.velocity = cv::Point2f(uniform(-maxSpeed, maxSpeed), uniform(-maxSpeed, maxSpeed));
+        object.color = cv::Scalar(uniform(40, 255), uniform(40, 255), uniform(40, 255));
+        objects.push_back(object);
+    }
+
+    LOG_DEBUG("[Synthetic] %d objects at %dx%d, seed %u",
+              options.numObjects, options.width, options.height, options.seed);
+}
+
+bool SyntheticSource::getNextFrame(Frame& frame) {
+    if (options.numFrames > 0 && framesProduced >= options.numFrames) {
+        return false;
+    }
+
+    frame.original.create(options.height, options.width, CV_8UC3);
+    frame.original.setTo(cv::Scalar(32, 32, 32));
+    frame.groundTruth.clear();
+    frame.groundTruthIDs.clear();
+
+    // Objects are stored back to front, so later ones occlude earlier ones
+    for (auto& object : objects) {
+        if (framesProduced > 0) {
+            object.position += object.velocity;
+
+            // Bounce off the frame borders
+            float maxX = options.width - object.size.width;
+            float maxY = options.height - object.size.height;
+            if (object.position.x < 0 || object.position.x > maxX) {
+                object.velocity.x = -object.velocity.x;
+                object.position.x = std::clamp(object.position.x, 0.0f, maxX);
+            }
+            if (object.position.y < 0 || object.position.y > maxY) {
+                object.velocity.y = -object.velocity.y;
+                object.position.y = std::clamp(object.position.y, 0.0f, maxY);
+            }
+        }
+
+        cv::Rect box(cv::Point(cvRound(object.position.x), cvRound(object.position.y)),
+                     cv::Size(cvRound(object.size.width), cvRound(object.size.height)));
+        cv::rectangle(frame.original, box, object.color, cv::FILLED);
+
+        frame.groundTruth.push_back(box);
+        frame.groundTruthIDs.push_back(object.id);
+    }
+
+    if (options.injectDetections) {
+        frame.detections = frame.groundTruth;
+        frame.hasDetections = true;
+    }
+
+    framesProduced++;
+    return true;
+}
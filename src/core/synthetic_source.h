@@ -0,0 +1,81 @@
+/**
+ * @file synthetic_source.h
+ * @brief Defines the SyntheticSource class for procedurally rendered test video
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "frame.h"
+
+/**
+ * @struct SyntheticSourceOptions
+ * @brief Parameters of the synthetic scene
+ */
+struct SyntheticSourceOptions {
+    int width = 1280;               /**< Frame width in pixels */
+    int height = 720;               /**< Frame height in pixels */
+    double fps = 30.0;              /**< Nominal frame rate */
+    int numObjects = 8;             /**< Number of moving rectangles */
+    int numFrames = 300;            /**< Frames to produce before end of stream (0 = unlimited) */
+    uint32_t seed = 42;             /**< Seed for the deterministic scene generator */
+    bool injectDetections = false;  /**< Fill Frame::detections with the ground truth */
+};
+
+/**
+ * @class SyntheticSource
+ * @brief Renders moving, mutually occluding rectangles together with their ground truth
+ *
+ * Every object keeps its ID for the whole stream and bounces off the frame borders.
+ * Objects are drawn back to front, so nearer objects occlude farther ones. The
+ * ground truth lists the full extent of every object, including occluded parts.
+ * The output is fully determined by the options, so runs are reproducible.
+ */
+class SyntheticSource {
+public:
+    /**
+     * @brief Constructor for the SyntheticSource class
+     * @param options Scene parameters
+     */
+    explicit SyntheticSource(const SyntheticSourceOptions& options);
+
+    /**
+     * @brief Restart the stream from its first frame
+     */
+    void reset();
+
+    /**
+     * @brief Render the next frame and its ground truth
+     * @param frame Receives the image in Frame::original and the boxes in Frame::groundTruth
+     * @return false once the configured number of frames has been produced
+     */
+    bool getNextFrame(Frame& frame);
+
+    /**
+     * @brief Get the nominal frame rate of the stream
+     * @return Frames per second
+     */
+    double getFrameRate() const { return options.fps; }
+
+private:
+    struct Object {
+        int id;                 ///< Ground truth ID
+        cv::Point2f position;   ///< Top-left corner
+        cv::Point2f velocity;   ///< Pixels per frame
+        cv::Size2f size;        ///< Box size
+        cv::Scalar color;       ///< Fill color
+    };
+
+    /**
+     * @brief Uniformly distributed value, independent of the standard library implementation
+     */
+    float uniform(float lo, float hi);
+
+    SyntheticSourceOptions options; ///< Scene parameters
+    std::mt19937 rng;               ///< Scene generator
+    std::vector<Object> objects;    ///< Objects ordered back to front
+    int framesProduced;             ///< Frames produced since the last reset
+};
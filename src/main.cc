@@ -1,26 +1,50 @@
 #include <iostream>
+#include <algorithm>
 #include <thread>
 #include <atomic>
 #include <string>
 #include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <vector>
 #include "config.h"
+#include "config_watcher.h"
 #include "logger.h"
 #include "thread_safe_queue.h"
 #include "frame.h"
 #include "frame_source.h"
 #include "onnx_model.h"
+#include "reid_model.h"
+#include "detection_cache.h"
+#include "quality_controller.h"
 #include "display.h"
+#include "recorder.h"
+#include "track_log.h"
 #include "preprocessor.h"
 #include "tracker.h"
+#include "pipeline.h"
+#include "benchmark.h"
 
 std::atomic<bool> shouldExit(false);
 std::atomic<bool> continuousMode(false);
+std::atomic<bool> fullFrameScanRequested(false);
 
 // Profiling variables
 std::atomic<long long> totalMainTime(0);
 std::atomic<long long> totalPreprocessTime(0);
 std::atomic<long long> totalTrackerTime(0);
+std::atomic<long long> totalInferenceTime(0);
 std::atomic<int> frameCount(0);
+std::atomic<int> capturedFrameCount(0);
+std::atomic<int> gatedFrameCount(0);
+
+// Process start, for the time to the first result
+std::chrono::steady_clock::time_point startupTime;
 
 // For real-time FPS calculation
 std::chrono::steady_clock::time_point lastFPSUpdateTime;
@@ -41,34 +65,114 @@ void printProfilingResults() {
     LOG_INFO("   Tracker avg time: %.2f ms", avgTrackerTime);
     LOG_INFO("   Total avg time per frame: %.2f ms", avgMainTime + avgPreprocessTime + avgTrackerTime);
     LOG_INFO("   Average FPS: %.2f", 1000.0 / (avgMainTime + avgPreprocessTime + avgTrackerTime));
+    if (gatedFrameCount > 0) {
+        LOG_INFO("   Frames without inference (motion gate): %d", gatedFrameCount.load());
+    }
 }
 
-bool initialization(const std::string& configPath) {
+// Maximum number of frames in flight through the pipeline in benchmark mode
+const int BENCHMARK_MAX_IN_FLIGHT = 4;
+
+bool initialization(const std::string& configPath, const BenchmarkOptions& benchmark) {
     // Load configuration
     if (!Config::loadFromFile(configPath)) {
         LOG_ERROR("Failed to load configuration file");
         return false;
     }
 
+    // The benchmark video overrides the input configured in the file
+    if (benchmark.enabled) {
+        Config::setInputSource(Config::InputSource::VIDEO);
+        Config::setVideoPath(benchmark.videoPath);
+    }
+
     // Set log level based on configuration
     int logLevelMask = Config::getLogLevelMask();
     Logger::getInstance().setLogLevel(logLevelMask);
 
-    // Load ONNX model
-    if (!ONNXModel::getInstance().loadModel(Config::getModelPath())) {
-        LOG_ERROR("Failed to load ONNX model");
+    // Opening the video or camera does not depend on the model, so it runs while the model loads
+    std::future<bool> sourceOpened = std::async(std::launch::async, [] {
+        auto start = std::chrono::steady_clock::now();
+        bool opened = FrameSource::getInstance().initialize();
+        LOG_INFO("Frame source opened in %.1f ms",
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        return opened;
+    });
+
+    // Load ONNX model, which is not needed when the synthetic source supplies detections
+    bool injectDetections = Config::getInputSource() == Config::InputSource::SYNTHETIC &&
+                            Config::getInjectGroundTruth();
+
+    // Cached detections also make the model unnecessary. The benchmark measures inference, so it never uses them.
+    bool cacheHit = false;
+    if (!injectDetections && !benchmark.enabled && !Config::getDetectionCacheDir().empty()) {
+        std::string sourcePath;
+        if (Config::getInputSource() == Config::InputSource::VIDEO) sourcePath = Config::getVideoPath();
+        else if (Config::getInputSource() == Config::InputSource::RAW) sourcePath = Config::getRawPath();
+
+        if (sourcePath.empty()) {
+            LOG_INFO("Detection cache only applies to video and raw sources");
+        } else {
+            std::string settings = Config::getLetterbox() ? "letterbox;" : "";
+            if (Config::getTilingEnabled()) {
+                settings += "tiles:" + std::to_string(Config::getTileSize()) + ":" +
+                           std::to_string(Config::getTileOverlap()) + ":" +
+                           std::to_string(Config::getTileFullFrame()) + ":" +
+                           std::to_string(Config::getTileNMSThreshold());
+            }
+            cacheHit = DetectionCache::getInstance().open(Config::getDetectionCacheDir(), sourcePath,
+                                                          Config::getModelPath(), ONNXModel::getInputSize(),
+                                                          Config::getConfidenceThreshold(), settings);
+        }
+    }
+
+    if (injectDetections) {
+        LOG_INFO("Synthetic ground truth replaces model inference, skipping model load");
+    } else if (cacheHit) {
+        LOG_INFO("Cached detections replace model inference, skipping model load");
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        if (!ONNXModel::getInstance().loadModel(Config::getModelPath())) {
+            LOG_ERROR("Failed to load ONNX model");
+            return false;
+        }
+        LOG_INFO("Model loaded in %.1f ms",
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        ONNXModel::getInstance().warmUp(Config::getWarmupRuns());
+    }
+
+    if (Config::getReIDEnabled() && !ReIDModel::getInstance().loadModel(Config::getReIDModelPath())) {
+        LOG_ERROR("Failed to load re-identification model");
         return false;
     }
 
-    // Frame source is already set by the config file
+    // The quality controller changes what the model sees, so it only runs on live inference
+    if (Config::getQualityEnabled()) {
+        if (injectDetections || cacheHit || benchmark.enabled || DetectionCache::getInstance().isRecording()) {
+            LOG_INFO("Quality controller disabled: detections are injected, cached, recorded or benchmarked");
+        } else {
+            QualityController::Options options;
+            options.targetFPS = Config::getQualityTargetFPS();
+            options.latencyBudgetMs = Config::getQualityLatencyBudget();
+            options.margin = Config::getQualityMargin();
+            options.windows = Config::getQualityWindows();
+            options.maxDetectionInterval = Config::getQualityMaxDetectionInterval();
+            options.minInputScale = Config::getQualityMinInputScale();
+            options.maxTileScale = Config::getQualityMaxTileScale();
+            options.inputSize = ONNXModel::getInputSize();
+            options.resizableInput = ONNXModel::getInstance().hasDynamicInputSize();
+            options.tileSize = Config::getTilingEnabled() ? Config::getTileSize() : 0;
+            QualityController::getInstance().configure(options);
+        }
+    }
 
-    // Initialize frame source
-    FrameSource& frameSource = FrameSource::getInstance();
-    if (!frameSource.initialize()) {
+    if (!sourceOpened.get()) {
         LOG_ERROR("Failed to initialize frame source");
         return false;
     }
 
+    LOG_INFO("Initialization finished %.1f ms after startup",
+             std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupTime).count());
     return true;
 }
 
@@ -97,37 +201,262 @@ void handleKeyboard(int key, Display& display) {
 }
 
 /**
- * Usage: ./object-tracking <path_to_config_file>
+ * @brief Parse a whole command line argument as an integer
+ * @return false if the text is not an integer in range
  */
-int main(int argc, char* argv[]) {
+bool parseIntArgument(const std::string& name, const char* text, int& value) {
+    errno = 0;
+    char* end = nullptr;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+        LOG_ERROR("%s expects an integer, got '%s'", name.c_str(), text);
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+/**
+ * @brief Parse command line arguments
+ * @return false if the arguments are invalid
+ */
+bool parseArguments(int argc, char* argv[], std::string& configPath, BenchmarkOptions& benchmark) {
     if (argc < 2) {
-        LOG_ERROR("Usage: %s <path_to_config_file>", argv[0]);
-        return 1;
+        return false;
+    }
+
+    configPath = argv[1];
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--benchmark" && hasValue) {
+            benchmark.enabled = true;
+            benchmark.videoPath = argv[++i];
+        } else if (arg == "--warmup" && hasValue) {
+            if (!parseIntArgument(arg, argv[++i], benchmark.warmupFrames)) return false;
+        } else if (arg == "--repeat" && hasValue) {
+            if (!parseIntArgument(arg, argv[++i], benchmark.repeat)) return false;
+        } else if (arg == "--benchmark-output" && hasValue) {
+            benchmark.outputPath = argv[++i];
+        } else {
+            LOG_WARNING("Ignoring unknown argument: %s", arg.c_str());
+        }
+    }
+
+    if (benchmark.warmupFrames < 0 || benchmark.repeat < 1) {
+        LOG_ERROR("--warmup must be >= 0 and --repeat must be >= 1");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Stream the video through the pipeline once, as fast as it will go
+ * @param maxFrames Stop after this many frames (-1 for the whole video)
+ * @param report Receives per-frame latencies (nullptr during warm-up)
+ * @return Number of frames processed, or -1 if the video could not be opened
+ */
+int runBenchmarkPass(ThreadSafeQueue<Frame>& preprocessQueue, ThreadSafeQueue<Frame>& displayQueue,
+                     int maxFrames, BenchmarkReport* report) {
+    FrameSource& frameSource = FrameSource::getInstance();
+    if (!frameSource.initialize()) {
+        return -1;
     }
 
-    std::string configPath = argv[1];
+    int submitted = 0;
+    int completed = 0;
+    bool sourceDone = false;
+
+    while (!sourceDone || completed < submitted) {
+        // Keep a bounded number of frames in flight so every stage stays busy
+        while (!sourceDone && submitted - completed < BENCHMARK_MAX_IN_FLIGHT) {
+            if (maxFrames >= 0 && submitted >= maxFrames) {
+                sourceDone = true;
+                break;
+            }
 
-    if (!initialization(configPath)) {
+            auto start = std::chrono::high_resolution_clock::now();
+            Frame frame;
+            if (frameSource.getNextFrame(frame)) {
+                preprocessQueue.push(std::move(frame));
+                submitted++;
+            } else {
+                sourceDone = true;
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            totalMainTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        }
+
+        if (completed < submitted) {
+            Frame result;
+            if (!displayQueue.pop(result)) break;
+            completed++;
+
+            if (report) {
+                auto latency = std::chrono::steady_clock::now() - result.captureTime;
+                report->addLatency(std::chrono::duration<double, std::milli>(latency).count());
+            }
+        }
+    }
+
+    return completed;
+}
+
+/**
+ * @brief Run the headless benchmark and emit a JSON summary
+ * @return Process exit code
+ */
+int runBenchmark(const BenchmarkOptions& options, ThreadSafeQueue<Frame>& preprocessQueue,
+                 ThreadSafeQueue<Frame>& displayQueue) {
+    LOG_INFO("Benchmarking %s (%d warm-up frames, %d passes)",
+             options.videoPath.c_str(), options.warmupFrames, options.repeat);
+
+    if (options.warmupFrames > 0 &&
+        runBenchmarkPass(preprocessQueue, displayQueue, options.warmupFrames, nullptr) < 0) {
         return 1;
     }
 
-    ThreadSafeQueue<Frame> preprocessQueue, trackingQueue, displayQueue;
+    // Only count stage time spent in the measured passes
+    long long mainStart = totalMainTime.load();
+    long long preprocessStart = totalPreprocessTime.load();
+    long long trackerStart = totalTrackerTime.load();
+    long long inferenceStart = totalInferenceTime.load();
 
-    ONNXModel& model = ONNXModel::getInstance();
-    Preprocessor preprocessor(preprocessQueue, trackingQueue, model.getMemoryInfo(), model.getInputNodeDims());
-    Tracker tracker(trackingQueue, displayQueue);
+    BenchmarkReport report;
+    for (int pass = 0; pass < options.repeat; ++pass) {
+        auto start = std::chrono::steady_clock::now();
+        int frames = runBenchmarkPass(preprocessQueue, displayQueue, -1, &report);
+        auto end = std::chrono::steady_clock::now();
+
+        if (frames < 0) {
+            return 1;
+        }
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        report.addPass(frames, seconds);
+        LOG_INFO("Pass %d/%d: %d frames, %.2f FPS", pass + 1, options.repeat, frames,
+                 seconds > 0 ? frames / seconds : 0.0);
+    }
+
+    report.setStageBusyTime("capture", totalMainTime.load() - mainStart);
+    report.setStageBusyTime("preprocess", totalPreprocessTime.load() - preprocessStart);
+    report.setStageBusyTime("tracker", totalTrackerTime.load() - trackerStart);
+    report.setStageBusyTime("inference", totalInferenceTime.load() - inferenceStart);
+
+    report.logSummary();
+
+    std::string json = report.toJSON(options);
+    if (options.outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(options.outputPath);
+        if (!out) {
+            LOG_ERROR("Failed to write benchmark summary to %s", options.outputPath.c_str());
+            return 1;
+        }
+        out << json;
+        LOG_INFO("Benchmark summary written to %s", options.outputPath.c_str());
+    }
 
-    std::thread preprocessThread(&Preprocessor::run, &preprocessor);
-    std::thread trackingThread(&Tracker::run, &tracker);
+    return 0;
+}
 
+/**
+ * @brief Capture loop for low-latency mode, feeding the newest frame into the pipeline mailbox
+ *
+ * Cameras and shared-memory producers are read as fast as they deliver. File sources
+ * are paced at their frame rate so they behave like a live feed.
+ */
+void runCapture(ThreadSafeQueue<Frame>& preprocessQueue, ThreadSafeQueue<Frame>& displayQueue) {
+    FrameSource& frameSource = FrameSource::getInstance();
+
+    bool paced = Config::getInputSource() != Config::InputSource::CAMERA &&
+                 Config::getInputSource() != Config::InputSource::SHM;
+    double fps = frameSource.getFrameRate();
+    auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / (fps > 0 ? fps : 30.0)));
+    auto nextCapture = std::chrono::steady_clock::now();
+
+    while (!shouldExit) {
+        if (paced) {
+            std::this_thread::sleep_until(nextCapture);
+            nextCapture += interval;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        Frame frame;
+        if (!frameSource.getNextFrame(frame)) {
+            LOG_INFO("End of video reached. Terminating program.");
+            DetectionCache::getInstance().markComplete(frameSource.getFrameCount());
+            shouldExit = true;
+            displayQueue.close();  // Wake up the display loop
+            break;
+        }
+        preprocessQueue.push(std::move(frame));
+        auto end = std::chrono::high_resolution_clock::now();
+        totalMainTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        capturedFrameCount++;
+    }
+}
+
+/**
+ * @brief Run the interactive display loop until the user quits or the video ends
+ * @param lowLatency Capture on a separate thread and display only the newest result
+ */
+void runInteractive(ThreadSafeQueue<Frame>& preprocessQueue, ThreadSafeQueue<Frame>& trackingQueue,
+                    ThreadSafeQueue<Frame>& displayQueue, bool lowLatency) {
     FrameSource& frameSource = FrameSource::getInstance();
     Display display;
 
+    std::unique_ptr<Recorder> recorder;
+    if (!Config::getOutputPath().empty()) {
+        Recorder::Options options;
+        options.path = Config::getOutputPath();
+        options.fourcc = Config::getOutputFourCC();
+        options.fps = Config::getOutputFPS() > 0 ? Config::getOutputFPS() : frameSource.getFrameRate();
+        if (options.fps <= 0) {
+            options.fps = 30.0;  // Image sequences and some cameras report no rate
+        }
+        options.everyNth = Config::getOutputEveryNth();
+        options.onlyWithDetections = Config::getOutputOnlyDetections();
+        options.queueSize = static_cast<size_t>(Config::getOutputQueueSize());
+        options.dropWhenFull = Config::getOutputDropWhenFull();
+        recorder = std::make_unique<Recorder>(options);
+    }
+
+    std::unique_ptr<TrackLogWriter> trackLog;
+    if (!Config::getTrackLogPath().empty()) {
+        trackLog = std::make_unique<TrackLogWriter>(Config::getTrackLogPath());
+    }
+
     Frame currentFrame;
     bool newFrameProcessed = false;
 
     lastFPSUpdateTime = std::chrono::steady_clock::now();
 
+    // Glass-to-glass latency: from frame acquisition to the result being shown
+    double latencySum = 0.0, latencyMax = 0.0;
+    double windowLatencySum = 0.0, windowLatencyMax = 0.0;
+    long long latencyFrames = 0;
+
+    std::thread captureThread;
+    if (lowLatency) {
+        continuousMode = true;
+        captureThread = std::thread(runCapture, std::ref(preprocessQueue), std::ref(displayQueue));
+        LOG_INFO("Low-latency mode: only the newest frame is processed at every stage");
+    }
+
+    // Stage time totals at the start of the current window, for the quality controller
+    QualityController& quality = QualityController::getInstance();
+    long long windowMainTime = 0, windowPreprocessTime = 0, windowTrackerTime = 0;
+
+    auto skippedFrames = [&]() {
+        return preprocessQueue.dropped() + trackingQueue.dropped() + displayQueue.dropped();
+    };
+
     auto processFrameFunc = [&]() {
         auto start = std::chrono::high_resolution_clock::now();
         if (frameSource.getNextFrame(currentFrame)) {
@@ -135,6 +464,7 @@ int main(int argc, char* argv[]) {
             newFrameProcessed = true;
         } else {
             LOG_INFO("End of video reached. Terminating program.");
+            DetectionCache::getInstance().markComplete(frameSource.getFrameCount());
             shouldExit = true;
         }
         auto end = std::chrono::high_resolution_clock::now();
@@ -144,32 +474,51 @@ int main(int argc, char* argv[]) {
     while (!shouldExit) {
         auto frameStartTime = std::chrono::steady_clock::now();
 
-        if (continuousMode || !newFrameProcessed) {
+        if (!lowLatency && (continuousMode || !newFrameProcessed)) {
             processFrameFunc();
             if (shouldExit) break;  // Exit the loop if end of video is reached
         }
 
         Frame processedFrame;
-        if (displayQueue.pop(processedFrame)) {
-            auto start = std::chrono::high_resolution_clock::now();
-            display.showFrame(processedFrame);
-            newFrameProcessed = false;
+        if (!displayQueue.pop(processedFrame)) break;  // The capture thread closed the queue at the end of the video
 
-            int key = cv::waitKey(1);
-            handleKeyboard(key, display);
-            auto end = std::chrono::high_resolution_clock::now();
-            totalMainTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        auto start = std::chrono::high_resolution_clock::now();
+        display.showFrame(processedFrame);
+        newFrameProcessed = false;
+
+        double latency = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - processedFrame.captureTime).count();
+        latencySum += latency;
+        latencyMax = std::max(latencyMax, latency);
+        windowLatencySum += latency;
+        windowLatencyMax = std::max(windowLatencyMax, latency);
+        if (latencyFrames == 0) {
+            LOG_INFO("First result shown %.1f ms after startup",
+                     std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupTime).count());
+        }
+        latencyFrames++;
 
-            frameCount++;
-            realtimeFrameCount++;
+        if (trackLog) {
+            trackLog->append(processedFrame.frameIndex, processedFrame.detections, processedFrame.trackIDs);
+        }
+        if (recorder) {
+            recorder->submit(processedFrame, display.isShowingBoundingBoxes(), display.getFPS());
+        }
 
-            if (!continuousMode) {
-                // In frame-by-frame mode, wait for user input
-                while (!shouldExit && !continuousMode) {
-                    key = cv::waitKey(0);
-                    handleKeyboard(key, display);
-                    if (key == ' ') break;  // Space key to advance to next frame
-                }
+        int key = cv::waitKey(1);
+        handleKeyboard(key, display);
+        auto end = std::chrono::high_resolution_clock::now();
+        totalMainTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        frameCount++;
+        realtimeFrameCount++;
+
+        if (!continuousMode) {
+            // In frame-by-frame mode, wait for user input
+            while (!shouldExit && !continuousMode) {
+                key = cv::waitKey(0);
+                handleKeyboard(key, display);
+                if (key == ' ') break;  // Space key to advance to next frame
             }
         }
 
@@ -189,8 +538,34 @@ int main(int argc, char* argv[]) {
             ss << std::put_time(std::localtime(&now_c), "%H:%M:%S");
 
             LOG_INFO("Real-time FPS (%s): %.2f", ss.str().c_str(), fps);
+            if (lowLatency && realtimeFrameCount > 0) {
+                LOG_INFO("   Latency avg %.1f ms, max %.1f ms, %zu frames skipped so far",
+                         windowLatencySum / realtimeFrameCount, windowLatencyMax, skippedFrames());
+            }
             display.setFPS(fps);
 
+            // Frame-by-frame mode runs at the user's pace, there is nothing to control
+            if (quality.isEnabled() && continuousMode && realtimeFrameCount > 0) {
+                long long mainTime = totalMainTime.load();
+                long long preprocessTime = totalPreprocessTime.load();
+                long long trackerTime = totalTrackerTime.load();
+                long long busiest = std::max({mainTime - windowMainTime, preprocessTime - windowPreprocessTime,
+                                              trackerTime - windowTrackerTime});
+
+                QualityController::Measurement measurement;
+                measurement.fps = fps;
+                measurement.latencyMs = windowLatencySum / realtimeFrameCount;
+                measurement.stageMs = static_cast<double>(busiest) / realtimeFrameCount / 1e6;
+                measurement.queueDepth = preprocessQueue.size() + trackingQueue.size() + displayQueue.size();
+                quality.update(measurement);
+            }
+            windowMainTime = totalMainTime.load();
+            windowPreprocessTime = totalPreprocessTime.load();
+            windowTrackerTime = totalTrackerTime.load();
+
+            windowLatencySum = 0.0;
+            windowLatencyMax = 0.0;
+
             lastFPSUpdateTime = currentTime;
             totalFrameTime = 0;
             realtimeFrameCount = 0;
@@ -200,17 +575,137 @@ int main(int argc, char* argv[]) {
         if (shouldExit) break;
     }
 
+    if (captureThread.joinable()) {
+        shouldExit = true;
+        captureThread.join();
+    }
+    if (lowLatency && latencyFrames > 0) {
+        LOG_INFO("Low-latency summary: %d frames captured, %lld shown, %zu skipped",
+                 capturedFrameCount.load(), latencyFrames, skippedFrames());
+        LOG_INFO("   Glass-to-glass latency avg %.1f ms, max %.1f ms", latencySum / latencyFrames, latencyMax);
+    }
+
+    if (recorder) {
+        recorder->stop();
+    }
+    if (trackLog) {
+        trackLog->close();
+    }
+}
+
+/**
+ * @brief Declare the stages run by the task scheduler
+ *
+ * Capture and display stay on their own threads at the ends of the graph: sources
+ * are not thread-safe and windows must be drawn from the main thread.
+ */
+void buildStageGraph(Pipeline& pipeline, Preprocessor& preprocessor, Tracker& tracker) {
+    using Mode = Pipeline::StageMode;
+    pipeline.addStage("schedule", Mode::SERIAL, [&preprocessor](Frame& frame) { preprocessor.schedule(frame); });
+    pipeline.addStage("preprocess", Mode::PARALLEL, [&preprocessor](Frame& frame) { preprocessor.prepare(frame); });
+    pipeline.addStage("infer", Mode::PARALLEL, [&tracker](Frame& frame) { tracker.detect(frame); });
+    pipeline.addStage("associate", Mode::SERIAL, [&tracker](Frame& frame) { tracker.associate(frame); });
+}
+
+/**
+ * Usage: ./object-tracking <path_to_config_file>
+ *        ./object-tracking <path_to_config_file> --benchmark <video> [--warmup <n>] [--repeat <n>]
+ *                          [--benchmark-output <file.json>]
+ */
+int main(int argc, char* argv[]) {
+    startupTime = std::chrono::steady_clock::now();
+    std::string configPath;
+    BenchmarkOptions benchmark;
+
+    if (!parseArguments(argc, argv, configPath, benchmark)) {
+        LOG_ERROR("Usage: %s <path_to_config_file> [--benchmark <video> [--warmup <n>] [--repeat <n>] "
+                  "[--benchmark-output <file>]]", argv[0]);
+        return 1;
+    }
+
+    // A summary printed to stdout must not be interleaved with log messages
+    if (benchmark.enabled && benchmark.outputPath.empty()) {
+        Logger::getInstance().setOutput(std::cerr);
+    }
+
+    if (!initialization(configPath, benchmark)) {
+        return 1;
+    }
+
+    // In low-latency mode every link is a single-slot mailbox holding only the newest frame
+    bool lowLatency = Config::getLowLatency() && !benchmark.enabled;
+    size_t queueCapacity = lowLatency ? 1 : 0;
+    QueueOverflowPolicy overflow = lowLatency ? QueueOverflowPolicy::DROP_OLDEST : QueueOverflowPolicy::BLOCK;
+    ThreadSafeQueue<Frame> preprocessQueue(queueCapacity, overflow);
+    ThreadSafeQueue<Frame> trackingQueue(queueCapacity, overflow);
+    ThreadSafeQueue<Frame> displayQueue(queueCapacity, overflow);
+
+    ONNXModel& model = ONNXModel::getInstance();
+    Preprocessor preprocessor(preprocessQueue, trackingQueue, model.getMemoryInfo(), model.getInputNodeDims(),
+                              model.getInputFormat());
+    Tracker tracker(trackingQueue, displayQueue);
+
+    // Local analytics processes read the tracks from shared memory; the writer never waits for them
+    std::unique_ptr<TrackResultsWriter> resultsWriter;
+    if (Config::getResultsEnabled()) {
+        resultsWriter = TrackResultsWriter::create(Config::getResultsShmName(),
+                                                   static_cast<uint32_t>(Config::getResultsSlots()),
+                                                   static_cast<uint32_t>(Config::getResultsMaxTracks()));
+        if (!resultsWriter) {
+            LOG_ERROR("Failed to create the results ring");
+            return 1;
+        }
+        tracker.setResultsWriter(resultsWriter.get());
+    }
+
+    // One thread per stage, or the stage graph as tasks on a work-stealing pool
+    std::unique_ptr<Pipeline> pipeline;
+    std::vector<std::thread> stageThreads;
+    if (Config::getTaskScheduler()) {
+        pipeline = std::make_unique<Pipeline>(preprocessQueue, displayQueue,
+                                              static_cast<size_t>(Config::getSchedulerWorkers()),
+                                              static_cast<size_t>(Config::getSchedulerMaxInFlight()));
+        buildStageGraph(*pipeline, preprocessor, tracker);
+        stageThreads.emplace_back(&Pipeline::run, pipeline.get(), std::cref(shouldExit));
+    } else {
+        stageThreads.emplace_back(&Preprocessor::run, &preprocessor);
+        stageThreads.emplace_back(&Tracker::run, &tracker);
+    }
+
+    // Thresholds, detection interval and log level follow edits of the file; the benchmark keeps its settings fixed
+    std::unique_ptr<ConfigWatcher> configWatcher;
+    if (Config::getReloadEnabled() && !benchmark.enabled) {
+        configWatcher = std::make_unique<ConfigWatcher>(configPath, std::chrono::milliseconds(Config::getReloadInterval()));
+        configWatcher->start();
+    }
+
+    int exitCode = 0;
+    if (benchmark.enabled) {
+        exitCode = runBenchmark(benchmark, preprocessQueue, displayQueue);
+    } else {
+        runInteractive(preprocessQueue, trackingQueue, displayQueue, lowLatency);
+    }
+
     shouldExit = true;
-    // Push empty frames to unblock queues
-    preprocessQueue.push(Frame());
-    trackingQueue.push(Frame());
-    displayQueue.push(Frame());
+    // Wake up the stages waiting on their queues
+    preprocessQueue.close();
+    trackingQueue.close();
+    displayQueue.close();
 
-    preprocessThread.join();
-    trackingThread.join();
+    for (auto& thread : stageThreads) {
+        thread.join();
+    }
+    if (configWatcher) {
+        configWatcher->stop();
+    }
+
+    // Keeps a recorded detection cache entry only if the whole stream was processed
+    DetectionCache::getInstance().close();
 
     // Print profiling results
-    printProfilingResults();
+    if (!benchmark.enabled) {
+        printProfilingResults();
+    }
 
-    return 0;
+    return exitCode;
 }
\ No newline at end of file
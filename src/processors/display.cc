@@ -1,5 +1,6 @@
 #include <opencv2/opencv.hpp>
 #include "display.h"
+#include "track_log.h"
 #include <chrono>
 #include <iomanip>
 #include <sstream>
@@ -16,6 +17,10 @@ Display::~Display() {
 }
 
 void Display::showFrame(const Frame& frame) {
+    cv::imshow(windowName, renderFrame(frame, showBoundingBoxes, fps));
+}
+
+cv::Mat Display::renderFrame(const Frame& frame, bool showBoundingBoxes, double fps) {
     cv::Mat displayFrame;
 
     // Resize the processed frame back to original dimensions if needed
@@ -64,7 +69,20 @@ void Display::showFrame(const Frame& frame) {
     cv::putText(displayFrame, fpsStream.str(), cv::Point(10, 30),
                 cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0, 255, 0), 2);
 
-    cv::imshow(windowName, displayFrame);
+    return displayFrame;
+}
+
+bool Display::loadLoggedTracks(Frame& frame, const TrackLogReader& trackLog) {
+    frame.processed = frame.original;
+
+    long position = trackLog.findFrame(frame.frameIndex);
+    if (position < 0) {
+        frame.detections.clear();
+        frame.trackIDs.clear();
+        return false;
+    }
+    TrackLogReader::decode(trackLog.frame(static_cast<size_t>(position)), frame.detections, frame.trackIDs);
+    return true;
 }
 
 void Display::toggleBoundingBoxes() {
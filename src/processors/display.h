@@ -11,6 +11,8 @@
 #include <chrono>
 #include <string>
 
+class TrackLogReader;
+
 /**
  * @class Display
  * @brief Manages the display of frames and associated information.
@@ -33,6 +35,26 @@ public:
      */
     void showFrame(const Frame& frame);
 
+    /**
+     * @brief Draw the display overlays (bounding boxes, track IDs, FPS) onto a copy of a frame.
+     * @param frame The Frame object to be rendered.
+     * @param showBoundingBoxes Whether to draw bounding boxes and track IDs.
+     * @param fps FPS value to print on the frame.
+     * @return The annotated image at the original frame size.
+     */
+    static cv::Mat renderFrame(const Frame& frame, bool showBoundingBoxes, double fps);
+
+    /**
+     * @brief Prepare a frame read from a source for rendering with the tracks of a track log.
+     *
+     * Logged boxes are in processed-frame coordinates, and processed frames keep the
+     * original size, so the original frame serves as the processed one.
+     * @param frame Frame from a FrameSource; receives processed, detections and trackIDs.
+     * @param trackLog Log to look the frame up in by its frame index.
+     * @return True if the log has an entry for the frame; otherwise the frame gets no tracks.
+     */
+    static bool loadLoggedTracks(Frame& frame, const TrackLogReader& trackLog);
+
     /**
      * @brief Toggle the display of bounding boxes on and off.
      */
@@ -49,6 +71,18 @@ public:
      */
     void setFPS(double newFPS) { fps = newFPS; }
 
+    /**
+     * @brief Get the current FPS value.
+     * @return The FPS value being displayed.
+     */
+    double getFPS() const { return fps; }
+
+    /**
+     * @brief Check whether bounding boxes are currently shown.
+     * @return True if bounding boxes are drawn.
+     */
+    bool isShowingBoundingBoxes() const { return showBoundingBoxes; }
+
 private:
     std::string windowName; ///< Name of the display window
     bool showBoundingBoxes; ///< Flag to control bounding box display
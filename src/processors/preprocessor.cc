@@ -2,43 +2,142 @@
 #include "image_process.h"
 #include "logger.h"
 #include "config.h"
+#include "detection_cache.h"
+#include "quality_controller.h"
+#include <algorithm>
 #include <chrono>
 
 extern std::atomic<bool> shouldExit;
 extern std::atomic<long long> totalPreprocessTime;
+extern std::atomic<int> gatedFrameCount;
+extern std::atomic<bool> fullFrameScanRequested;
 
 Preprocessor::Preprocessor(ThreadSafeQueue<Frame>& input, ThreadSafeQueue<Frame>& output,
-                           const Ort::MemoryInfo& memory_info, const std::vector<int64_t>& input_node_dims)
-    : inputQueue(input), outputQueue(output), memory_info(memory_info), input_node_dims(input_node_dims) {
+                           const Ort::MemoryInfo& memory_info, const std::vector<int64_t>& input_node_dims,
+                           const InputTensorFormat& input_format)
+    : inputQueue(input), outputQueue(output), memory_info(memory_info), input_node_dims(input_node_dims),
+      input_format(input_format) {
+    // The model is not loaded when detections are injected by the frame source
+    inputWidth = input_node_dims.size() == 4 ? static_cast<int>(input_node_dims[3]) : 0;
+    inputHeight = input_node_dims.size() == 4 ? static_cast<int>(input_node_dims[2]) : 0;
+    LOG_DEBUG("[Preproc] Input width %d, height %d", inputWidth, inputHeight);
+
+    // A detection cache recording needs the model output of every frame
+    bool recording = DetectionCache::getInstance().isRecording();
+    if (Config::getMotionGateEnabled() && !recording) {
+        motionGate = std::make_unique<MotionGate>(Config::getMotionGateWidth(), Config::getMotionGateThreshold(),
+                                                  Config::getMotionGateRefresh());
+    }
+    roiEnabled = Config::getROIEnabled() && !recording;
 }
 
 void Preprocessor::run() {
-    int inputWidth = input_node_dims[3];
-    int inputHeight = input_node_dims[2];
-    LOG_DEBUG("[Preproc] Input width %d, height %d", inputWidth, inputHeight);
+    Frame frame;
+    while (!shouldExit && inputQueue.pop(frame)) {
+        if (frame.original.empty()) {
+            LOG_ERROR("[Preproc] Frame.original is empty");
+            continue;
+        }
+
+        schedule(frame);
+        prepare(frame);
+        outputQueue.push(std::move(frame));
+
+        LOG_DEBUG("[Preproc] Finished preproc and pushed to output queue");
+    }
+}
 
-    while (!shouldExit) {
-        Frame frame;
-        if (inputQueue.pop(frame)) {
-            auto start = std::chrono::high_resolution_clock::now();
+void Preprocessor::schedule(Frame& frame) {
+    auto start = std::chrono::high_resolution_clock::now();
 
-            if (frame.original.empty()) {
-                LOG_ERROR("[Preproc] Frame.original is empty");
-                continue;
-            }
+    DetectionCache& cache = DetectionCache::getInstance();
 
-            // For output frame data
-            frame.processed = ImageProcessor::processFrame(frame.original, inputWidth, inputHeight);
+    // Cached detections replace inference; the model is not loaded on a cache hit
+    if (cache.isHit()) {
+        if (!cache.lookup(frame.frameIndex, frame.detections)) {
+            LOG_WARNING("[Preproc] Frame %lld missing from detection cache",
+                        static_cast<long long>(frame.frameIndex));
+        }
+        frame.hasDetections = true;
+    }
 
-            // Preprocess for ONNX
-            frame.onnx_input = ImageProcessor::preprocessForONNX(frame.processed, memory_info, input_node_dims);
+    // Unchanged frames reuse the detections of the last inferred frame
+    if (motionGate && !frame.hasDetections && !motionGate->shouldInfer(frame.original)) {
+        frame.reuseDetections = true;
+        gatedFrameCount++;
+    }
 
-            outputQueue.push(std::move(frame));
+    // The configuration or the quality controller may only infer every Nth frame; a recorded cache needs every frame
+    QualityController::Settings settings = QualityController::getInstance().current();
+    int detectionInterval = cache.isRecording() ? 1 : std::max(settings.detectionInterval, Config::getDetectionInterval());
+    if (!frame.hasDetections && !frame.reuseDetections) {
+        if (framesSinceDetection >= 0 && ++framesSinceDetection < detectionInterval) {
+            frame.reuseDetections = true;
+        } else {
+            framesSinceDetection = 0;
+        }
+    }
 
-            auto end = std::chrono::high_resolution_clock::now();
-            totalPreprocessTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    bool needsInference = !frame.hasDetections && !frame.reuseDetections;
 
-            LOG_DEBUG("[Preproc] Finished preproc and pushed to output queue");
+    // Between full scans the Tracker builds the input from its tracks
+    if (needsInference && roiEnabled) {
+        bool fullScan = framesSinceFullScan < 0 ||
+                        framesSinceFullScan + 1 >= Config::getROIFullScanInterval() ||
+                        fullFrameScanRequested.exchange(false);
+        if (fullScan) {
+            framesSinceFullScan = 0;
+        } else {
+            framesSinceFullScan++;
+            frame.roiInference = true;
+            needsInference = false;
         }
     }
-}
\ No newline at end of file
+
+    frame.regions.clear();
+    if (needsInference && Config::getTilingEnabled()) {
+        planTiles(frame, settings.tileSize);
+    } else if (needsInference) {
+        frame.regions = {InferenceRegion{cv::Rect(cv::Point(0, 0), frame.original.size())}};
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    totalPreprocessTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+void Preprocessor::prepare(Frame& frame) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // For output frame data
+    frame.processed = ImageProcessor::processFrame(frame.original, inputWidth, inputHeight);
+
+    // Preprocess for ONNX, unless the detections are already known
+    if (!frame.regions.empty()) {
+        frame.onnx_input = ImageProcessor::preprocessRegionsForONNX(frame.processed, frame.regions, Config::getLetterbox(),
+                                                                    frame.inputBlob, memory_info,
+                                                                    QualityController::getInstance().inputDims(input_node_dims),
+                                                                    input_format);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    totalPreprocessTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+void Preprocessor::planTiles(Frame& frame, int tileSize) {
+    if (frame.original.size() != tiledFrameSize || tileSize != tiledTileSize) {
+        tiledFrameSize = frame.original.size();
+        tiledTileSize = tileSize;
+        tiles = ImageProcessor::computeTiles(tiledFrameSize, tileSize, Config::getTileOverlap());
+        LOG_INFO("[Preproc] Tiling %dx%d frames into %zu tiles of %d px",
+                 tiledFrameSize.width, tiledFrameSize.height, tiles.size(), tileSize);
+    }
+
+    for (const cv::Rect& tile : tiles) {
+        frame.regions.push_back(InferenceRegion{tile});
+    }
+
+    // A single tile already covers the whole frame
+    if (Config::getTileFullFrame() && tiles.size() > 1) {
+        frame.regions.push_back(InferenceRegion{cv::Rect(cv::Point(0, 0), frame.original.size())});
+    }
+}
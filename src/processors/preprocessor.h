@@ -7,7 +7,9 @@
 
 #include "frame.h"
 #include "thread_safe_queue.h"
+#include "motion_gate.h"
 #include <onnxruntime_cxx_api.h>
+#include <memory>
 #include <vector>
 
 /**
@@ -22,9 +24,11 @@ public:
      * @param output Reference to the output queue where processed frames will be placed.
      * @param memory_info ONNX Runtime memory information.
      * @param input_node_dims Dimensions of the input node for the ONNX model.
+     * @param input_format Element type and layout of the ONNX model input.
      */
     Preprocessor(ThreadSafeQueue<Frame>& input, ThreadSafeQueue<Frame>& output, 
-                 const Ort::MemoryInfo& memory_info, const std::vector<int64_t>& input_node_dims);
+                 const Ort::MemoryInfo& memory_info, const std::vector<int64_t>& input_node_dims,
+                 const InputTensorFormat& input_format);
 
     /**
      * @brief Main processing loop for the Preprocessor.
@@ -34,9 +38,42 @@ public:
      */
     void run();
 
+    /**
+     * @brief Decide how a frame is detected: cached, reused, around tracks, tiled or whole.
+     *
+     * Keeps state across frames, so frames must be passed one at a time in stream order.
+     * @param frame Frame to schedule; receives the regions to infer, if any.
+     */
+    void schedule(Frame& frame);
+
+    /**
+     * @brief Build the model input for the regions chosen by schedule().
+     *
+     * Stateless, so it may run for several frames at once.
+     * @param frame Scheduled frame; receives processed and, if it has regions, onnx_input.
+     */
+    void prepare(Frame& frame);
+
 private:
+    /**
+     * @brief Add overlapping tile regions (and optionally the full frame) to a frame.
+     * @param frame Frame to plan; receives one region per batch entry.
+     * @param tileSize Tile side length in pixels.
+     */
+    void planTiles(Frame& frame, int tileSize);
+
     ThreadSafeQueue<Frame>& inputQueue; ///< Reference to the input queue
     ThreadSafeQueue<Frame>& outputQueue; ///< Reference to the output queue
     const Ort::MemoryInfo& memory_info; ///< ONNX Runtime memory information
     const std::vector<int64_t>& input_node_dims; ///< Dimensions of the ONNX model input node
+    InputTensorFormat input_format; ///< Element type and layout of the ONNX model input
+    int inputWidth = 0; ///< Model input width, 0 if no model is loaded
+    int inputHeight = 0; ///< Model input height, 0 if no model is loaded
+    std::vector<cv::Rect> tiles; ///< Tile layout for tiledFrameSize
+    cv::Size tiledFrameSize; ///< Frame size the tile layout was computed for
+    int tiledTileSize = 0; ///< Tile size the tile layout was computed for
+    std::unique_ptr<MotionGate> motionGate; ///< Change detector, null when the gate is disabled
+    bool roiEnabled = false; ///< Frames between full scans are only inferred around tracks
+    int framesSinceFullScan = -1; ///< ROI frames since the last full scan, -1 before the first frame
+    int framesSinceDetection = -1; ///< Frames since the last inferred one under the quality controller, -1 before the first
 };
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "recorder.h"
+#include "display.h"
+#include "logger.h"
+#include <algorithm>
+
+Recorder::Recorder(const Options& options)
+    : options(options),
+      queue(std::max<size_t>(1, options.queueSize)) {
+    this->options.everyNth = std::max(1, options.everyNth);
+    thread = std::thread(&Recorder::run, this);
+}
+
+Recorder::~Recorder() {
+    stop();
+}
+
+void Recorder::submit(Frame& frame, bool showBoundingBoxes, double fps) {
+    if (frame.original.empty()) return;
+
+    size_t index = submittedFrames++;
+    if (index % options.everyNth != 0) return;
+    if (options.onlyWithDetections && frame.detections.empty()) return;
+
+    Job job;
+    job.frame = std::move(frame);
+    job.showBoundingBoxes = showBoundingBoxes;
+    job.fps = fps;
+
+    if (!options.dropWhenFull) {
+        queue.push(std::move(job));
+    } else if (!queue.try_push(std::move(job))) {
+        // Hand the frame back so the caller still owns it
+        frame = std::move(job.frame);
+        droppedFrames++;
+    }
+}
+
+void Recorder::stop() {
+    if (stopped) return;
+    stopped = true;
+
+    queue.close();
+    thread.join();
+
+    if (writer.isOpened()) {
+        writer.release();
+    }
+    LOG_INFO("Recorder wrote %zu frames to %s (%zu dropped)",
+             writtenFrames.load(), options.path.c_str(), droppedFrames.load());
+}
+
+void Recorder::run() {
+    bool failed = false;
+    Job job;
+    while (queue.pop(job)) {
+        if (failed) continue;
+
+        cv::Mat annotated = Display::renderFrame(job.frame, job.showBoundingBoxes, job.fps);
+
+        if (!writer.isOpened()) {
+            const std::string& code = options.fourcc;
+            int fourcc = code.size() == 4 ? cv::VideoWriter::fourcc(code[0], code[1], code[2], code[3]) : 0;
+            if (!writer.open(options.path, fourcc, options.fps, annotated.size())) {
+                LOG_ERROR("Failed to open output video %s", options.path.c_str());
+                failed = true;
+                continue;
+            }
+            LOG_INFO("Recording %dx%d at %.2f FPS to %s",
+                     annotated.cols, annotated.rows, options.fps, options.path.c_str());
+        }
+
+        writer.write(annotated);
+        writtenFrames++;
+    }
+}
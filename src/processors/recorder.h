@@ -0,0 +1,107 @@
+/**
+ * @file recorder.h
+ * @brief Header file for the Recorder class, responsible for writing annotated video.
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <opencv2/opencv.hpp>
+#include "frame.h"
+#include "thread_safe_queue.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+/**
+ * @class Recorder
+ * @brief Encodes annotated frames to a video file on a background thread.
+ *
+ * Frames are handed over after display through a bounded queue, so the encoder
+ * never runs on the capture, preprocessing or tracking threads. When the queue is
+ * full the frame is either dropped or the caller waits, depending on the policy.
+ * Frame selection (every Nth frame, frames with detections only) happens before
+ * queuing so skipped frames cost nothing.
+ */
+class Recorder {
+public:
+    /**
+     * @struct Options
+     * @brief Output settings for the recorder.
+     */
+    struct Options {
+        std::string path;                ///< Output video file
+        std::string fourcc = "mp4v";     ///< Four character codec code
+        double fps = 30.0;               ///< Frame rate written to the container
+        int everyNth = 1;                ///< Write one of every N submitted frames
+        bool onlyWithDetections = false; ///< Skip frames without detections
+        size_t queueSize = 8;            ///< Maximum number of frames waiting for the encoder
+        bool dropWhenFull = true;        ///< Drop frames instead of blocking when the queue is full
+    };
+
+    /**
+     * @brief Constructor for the Recorder class. Starts the encoder thread.
+     * @param options Output settings.
+     */
+    explicit Recorder(const Options& options);
+
+    /**
+     * @brief Destructor for the Recorder class. Flushes queued frames and closes the file.
+     */
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    /**
+     * @brief Offer a processed frame for recording.
+     * @param frame The processed frame; moved from only if it is queued.
+     * @param showBoundingBoxes Whether to draw bounding boxes and track IDs.
+     * @param fps FPS value to print on the frame.
+     */
+    void submit(Frame& frame, bool showBoundingBoxes, double fps);
+
+    /**
+     * @brief Flush queued frames, stop the encoder thread and close the file.
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of frames written to the file.
+     * @return Number of written frames.
+     */
+    size_t getWrittenFrames() const { return writtenFrames; }
+
+    /**
+     * @brief Get the number of selected frames dropped because the queue was full.
+     * @return Number of dropped frames.
+     */
+    size_t getDroppedFrames() const { return droppedFrames; }
+
+private:
+    /**
+     * @struct Job
+     * @brief A frame waiting to be encoded together with its overlay settings.
+     */
+    struct Job {
+        Frame frame;
+        bool showBoundingBoxes = true;
+        double fps = 0.0;
+    };
+
+    /**
+     * @brief Encoder loop run by the background thread.
+     */
+    void run();
+
+    Options options;                       ///< Output settings
+    ThreadSafeQueue<Job> queue;            ///< Frames waiting for the encoder
+    cv::VideoWriter writer;                ///< Opened on the first frame, when the size is known
+    std::thread thread;                    ///< Encoder thread
+    size_t submittedFrames = 0;            ///< Frames offered by submit(), used for every-Nth selection
+    std::atomic<size_t> writtenFrames{0};  ///< Frames encoded
+    std::atomic<size_t> droppedFrames{0};  ///< Frames dropped on a full queue
+    bool stopped = false;                  ///< stop() has already run
+};
+
+#endif // RECORDER_H
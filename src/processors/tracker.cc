@@ -2,67 +2,195 @@
 #include "onnx_model.h"
 #include "logger.h"
 #include "config.h"
+#include "detection_cache.h"
+#include "image_process.h"
+#include "quality_controller.h"
+#include "assignment.h"
 #include <algorithm>
+#include <cmath>
 #include <chrono>
 
 extern std::atomic<bool> shouldExit;
 extern std::atomic<long long> totalTrackerTime;
+extern std::atomic<long long> totalInferenceTime;
+extern std::atomic<bool> fullFrameScanRequested;
 
 Tracker::Tracker(ThreadSafeQueue<Frame>& input, ThreadSafeQueue<Frame>& output)
-    : inputQueue(input), outputQueue(output), nextTrackID(1) {
+    : inputQueue(input), outputQueue(output), nextTrackID(1),
+      trajectories(static_cast<size_t>(Config::getTrajectoryLength())) {
 }
 
 void Tracker::run() {
-    ONNXModel& model = ONNXModel::getInstance();
-    
-    while (!shouldExit) {
-        Frame frame;
-        if (inputQueue.pop(frame)) {
-            auto start = std::chrono::high_resolution_clock::now();
-
-            if (frame.processed.empty()) { 
-                LOG_ERROR("[Tracker] Frame.processed is empty");
-                continue; 
-            }
+    const size_t maxInFlight = static_cast<size_t>(Config::getInferenceInFlight());
 
-            if (!frame.onnx_input.has_value()) {
-                LOG_ERROR("[Tracker] Frame has no ONNX input tensor");
-                frame.detections.clear();
+    Frame frame;
+    while (!shouldExit) {
+        if (inFlight.size() < maxInFlight) {
+            // Only wait for input when nothing is in flight, otherwise finish the oldest frame meanwhile
+            bool popped = inFlight.empty() ? inputQueue.pop(frame) : inputQueue.try_pop(frame);
+            if (popped) {
+                if (frame.processed.empty()) { 
+                    LOG_ERROR("[Tracker] Frame.processed is empty");
+                    continue; 
+                }
+                dispatch(std::move(frame));
                 continue;
             }
+            if (inFlight.empty()) break;  // Queue closed
+        }
+        completeOldest();
+    }
 
-            // Perform object detection using the ONNX model
-            auto detect_start = std::chrono::high_resolution_clock::now();
-            frame.detections = model.detect(frame.onnx_input.value(), frame.original.size());
-            auto detect_end = std::chrono::high_resolution_clock::now();
-            auto detect_time = std::chrono::duration_cast<std::chrono::nanoseconds>(detect_end - detect_start).count();
-            LOG_DEBUG("[Tracker] ONNX detection time: %.3f ms", detect_time / 1e6);
+    // The model may still be reading the input of frames in flight
+    for (PendingFrame& pending : inFlight) {
+        if (pending.detections.valid()) pending.detections.wait();
+    }
+    inFlight.clear();
+}
+
+void Tracker::dispatch(Frame&& frame) {
+    inFlight.emplace_back();
+    PendingFrame& pending = inFlight.back();
+    pending.frame = std::move(frame);
 
-            // Update tracks and associate track IDs with detections
-            auto update_start = std::chrono::high_resolution_clock::now();
-            updateTracks(frame);
-            auto update_end = std::chrono::high_resolution_clock::now();
-            auto update_time = std::chrono::duration_cast<std::chrono::nanoseconds>(update_end - update_start).count();
-            LOG_DEBUG("[Tracker] Track update time: %.3f ms", update_time / 1e6);
+    bool needsModel = !pending.frame.hasDetections && !pending.frame.reuseDetections && !pending.frame.roiInference;
+    if (!needsModel || !pending.frame.onnx_input.has_value() || Config::getInferenceInFlight() == 1) {
+        // Nothing to overlap with; runModel() reports a missing input
+        detect(pending.frame);
+        return;
+    }
 
-            outputQueue.push(std::move(frame));
+    pending.dispatched = std::chrono::steady_clock::now();
+    pending.detections = ONNXModel::getInstance().detectAsync(pending.frame.onnx_input.value(), pending.frame.regions,
+                                                              &pending.frame.scores);
+}
 
-            auto end = std::chrono::high_resolution_clock::now();
-            auto total_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
-            LOG_DEBUG("[Tracker] Frame processing time: %.3f ms", total_time / 1e6);
+void Tracker::completeOldest() {
+    PendingFrame& pending = inFlight.front();
+    if (pending.detections.valid()) {
+        // Time spent waiting here is the inference this thread could not hide
+        auto wait_start = std::chrono::steady_clock::now();
+        pending.frame.detections = pending.detections.get();
+        pending.frame.hasDetections = true;
+        auto wait_end = std::chrono::steady_clock::now();
+        totalTrackerTime += std::chrono::duration_cast<std::chrono::nanoseconds>(wait_end - wait_start).count();
+        totalInferenceTime += std::chrono::duration_cast<std::chrono::nanoseconds>(wait_end - pending.dispatched).count();
+    }
+
+    associate(pending.frame);
+    outputQueue.push(std::move(pending.frame));
+    inFlight.pop_front();
+}
 
-            // Update the totalTrackerTime
-            totalTrackerTime += total_time;
+void Tracker::detect(Frame& frame) {
+    // Reused detections and ROI crops depend on the tracks, so associate() handles those
+    if (frame.hasDetections || frame.reuseDetections || frame.roiInference) return;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    runModel(frame);
+    auto end = std::chrono::high_resolution_clock::now();
+    totalTrackerTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+void Tracker::runModel(Frame& frame) {
+    if (!frame.onnx_input.has_value()) {
+        LOG_ERROR("[Tracker] Frame has no ONNX input tensor");
+        frame.detections.clear();
+        return;
+    }
+
+    // Perform object detection using the ONNX model
+    auto detect_start = std::chrono::high_resolution_clock::now();
+    frame.detections = ONNXModel::getInstance().detect(frame.onnx_input.value(), frame.regions, &frame.scores);
+    frame.hasDetections = true;
+    auto detect_end = std::chrono::high_resolution_clock::now();
+    auto detect_time = std::chrono::duration_cast<std::chrono::nanoseconds>(detect_end - detect_start).count();
+    LOG_DEBUG("[Tracker] ONNX detection time: %.3f ms", detect_time / 1e6);
+    totalInferenceTime += detect_time;
+}
+
+void Tracker::associate(Frame& frame) {
+    auto start = std::chrono::high_resolution_clock::now();
+    DetectionCache& cache = DetectionCache::getInstance();
+
+    if (frame.reuseDetections) {
+        // The scene has not changed or this frame is not due for inference, so the previous detections hold
+        frame.detections = lastDetections;
+        frame.scores = lastScores;
+        LOG_DEBUG("[Tracker] No inference on this frame, reusing %zu detections", frame.detections.size());
+    } else if (frame.roiInference) {
+        if (!prepareTrackRegions(frame)) {
+            // Nothing to look around, scan the whole frame instead
+            frame.roiInference = false;
+            frame.regions = {InferenceRegion{cv::Rect(cv::Point(0, 0), frame.processed.size())}};
+            ONNXModel& model = ONNXModel::getInstance();
+            std::vector<int64_t> dims = QualityController::getInstance().inputDims(model.getInputNodeDims());
+            frame.onnx_input = ImageProcessor::preprocessRegionsForONNX(frame.processed, frame.regions,
+                                                                        Config::getLetterbox(), frame.inputBlob,
+                                                                        model.getMemoryInfo(), dims, model.getInputFormat());
         }
+        runModel(frame);
+    } else if (frame.hasDetections) {
+        LOG_DEBUG("[Tracker] Using %zu detections", frame.detections.size());
+    }
+
+    // Frames reach this point in stream order, so the recording has no gaps unless inference failed
+    if (cache.isRecording() && frame.hasDetections) {
+        cache.record(frame.frameIndex, frame.detections);
+    }
+
+    lastDetections = frame.detections;
+    lastScores = frame.scores;
+
+    // Update tracks and associate track IDs with detections
+    auto update_start = std::chrono::high_resolution_clock::now();
+    updateTracks(frame);
+    auto update_end = std::chrono::high_resolution_clock::now();
+    auto update_time = std::chrono::duration_cast<std::chrono::nanoseconds>(update_end - update_start).count();
+    LOG_DEBUG("[Tracker] Track update time: %.3f ms", update_time / 1e6);
+
+    if (resultsWriter) {
+        publishResults(frame);
     }
+
+    // A track that left its crop may be anywhere now
+    if (frame.roiInference && hasMissedTracks()) {
+        fullFrameScanRequested = true;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto total_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    LOG_DEBUG("[Tracker] Frame processing time: %.3f ms", total_time / 1e6);
+
+    // Update the totalTrackerTime
+    totalTrackerTime += total_time;
 }
 
 
+void Tracker::publishResults(const Frame& frame) {
+    resultRecords.clear();
+    bool hasScores = frame.scores.size() == frame.detections.size();
+    for (size_t i = 0; i < frame.detections.size() && i < frame.trackIDs.size(); ++i) {
+        if (frame.trackIDs[i] < 0) continue;
+        const cv::Rect& box = frame.detections[i];
+        resultRecords.push_back({frame.trackIDs[i], box.x, box.y, box.width, box.height,
+                                 hasScores ? frame.scores[i] : 0.0f});
+    }
+
+    int64_t captureTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        frame.captureTime.time_since_epoch()).count();
+    resultsWriter->publish(frame.frameIndex, captureTime, static_cast<uint32_t>(frame.original.cols),
+                           static_cast<uint32_t>(frame.original.rows), resultRecords.data(), resultRecords.size());
+}
+
 bool Tracker::getProcessedFrame(Frame& frame) {
     return outputQueue.pop(frame);
 }
 
 void Tracker::updateTracks(Frame& frame) {
+    const float iouThreshold = Config::getIoUThreshold();
+    const int maxFramesToSkip = Config::getMaxFramesToSkip();
+
     // Predict new locations of existing tracks
     for (auto& track : tracks) {
         track.second.predict();
@@ -70,34 +198,57 @@ void Tracker::updateTracks(Frame& frame) {
 
     // Associate detections with existing tracks
     std::vector<int> unassignedDetections;
+    std::vector<std::vector<float>> embeddings;
     frame.trackIDs.clear();
     frame.trackIDs.resize(frame.detections.size(), -1);  // Initialize with -1 (no track)
 
-    for (size_t i = 0; i < frame.detections.size(); ++i) {
-        bool assigned = false;
-        for (auto& track : tracks) {
-            if (calculateIoU(frame.detections[i], track.second.rect) > 0.5) {
-                track.second.update(frame.detections[i]);
-                frame.trackIDs[i] = track.first;  // Assign track ID to detection
-                assigned = true;
-                break;
+    if (embedder || (Config::getReIDEnabled() && ReIDModel::getInstance().isLoaded())) {
+        matchWithAppearance(frame, unassignedDetections, embeddings);
+    } else {
+        for (size_t i = 0; i < frame.detections.size(); ++i) {
+            bool assigned = false;
+            for (auto& track : tracks) {
+                if (calculateIoU(frame.detections[i], track.second.rect) > iouThreshold) {
+                    track.second.update(frame.detections[i]);
+                    frame.trackIDs[i] = track.first;  // Assign track ID to detection
+                    assigned = true;
+                    break;
+                }
+            }
+            if (!assigned) {
+                unassignedDetections.push_back(i);
             }
-        }
-        if (!assigned) {
-            unassignedDetections.push_back(i);
         }
     }
 
     // Create new tracks for unassigned detections
     for (int i : unassignedDetections) {
         tracks[nextTrackID] = Track(frame.detections[i], nextTrackID);
+        tracks[nextTrackID].trajectorySlot = trajectories.acquire();
+        if (static_cast<size_t>(i) < embeddings.size() && !embeddings[i].empty()) {
+            tracks[nextTrackID].addEmbedding(std::move(embeddings[i]));
+        }
         frame.trackIDs[i] = nextTrackID;  // Assign new track ID to detection
         nextTrackID++;
     }
 
+    // Record the observed state of every matched or new track
+    bool scored = frame.scores.size() == frame.detections.size();
+    for (size_t i = 0; i < frame.detections.size(); ++i) {
+        auto track = tracks.find(frame.trackIDs[i]);
+        if (track == tracks.end()) continue;
+        TrajectoryPoint point;
+        point.box = frame.detections[i];
+        point.timestamp = frame.captureTime;
+        point.frameIndex = frame.frameIndex;
+        point.score = scored ? frame.scores[i] : 0.0f;
+        trajectories.append(track->second.trajectorySlot, point);
+    }
+
     // Remove old tracks
     for (auto it = tracks.begin(); it != tracks.end();) {
-        if (it->second.timeSinceUpdate > 10) {
+        if (it->second.timeSinceUpdate > maxFramesToSkip) {
+            trajectories.release(it->second.trajectorySlot);
             it = tracks.erase(it);
         } else {
             ++it;
@@ -105,6 +256,150 @@ void Tracker::updateTracks(Frame& frame) {
     }
 }
 
+void Tracker::matchWithAppearance(Frame& frame, std::vector<int>& unassignedDetections,
+                                  std::vector<std::vector<float>>& embeddings) {
+    const float iouThreshold = Config::getIoUThreshold();
+    const double appearanceWeight = Config::getReIDAppearanceWeight();
+    const double maxDistance = Config::getReIDMaxDistance();
+    const double maxDisplacement = Config::getReIDMaxDisplacement();
+    const int refreshInterval = Config::getReIDRefreshInterval();
+
+    std::vector<Track*> columns;
+    bool lostTracks = false;
+    for (auto& track : tracks) {
+        columns.push_back(&track.second);
+        // predict() already ran, so a track seen on the previous frame is at 1
+        lostTracks = lostTracks || (track.second.timeSinceUpdate > 1 && !track.second.gallery.empty());
+    }
+
+    const size_t detectionCount = frame.detections.size();
+    std::vector<std::vector<float>> overlap(detectionCount, std::vector<float>(columns.size()));
+    std::vector<int> detectionCandidates(detectionCount, 0);
+    std::vector<int> trackCandidates(columns.size(), 0);
+    for (size_t i = 0; i < detectionCount; ++i) {
+        for (size_t j = 0; j < columns.size(); ++j) {
+            overlap[i][j] = calculateIoU(frame.detections[i], columns[j]->rect);
+            if (overlap[i][j] > iouThreshold) {
+                detectionCandidates[i]++;
+                trackCandidates[j]++;
+            }
+        }
+    }
+
+    // Pairs that overlap only each other are settled by IoU; only the rest need an embedding
+    std::vector<int> assigned(detectionCount, -1);
+    std::vector<bool> trackTaken(columns.size(), false);
+    std::vector<size_t> ambiguous;
+    std::vector<size_t> toEmbed;
+    for (size_t i = 0; i < detectionCount; ++i) {
+        if (detectionCandidates[i] == 1) {
+            size_t j = 0;
+            while (overlap[i][j] <= iouThreshold) ++j;
+            if (trackCandidates[j] == 1) {
+                assigned[i] = static_cast<int>(j);
+                trackTaken[j] = true;
+                const Track& track = *columns[j];
+                if (refreshInterval > 0 && (track.gallery.empty() || track.framesSinceEmbedding >= refreshInterval)) {
+                    toEmbed.push_back(i);
+                }
+                continue;
+            }
+        }
+        if (detectionCandidates[i] > 0 || lostTracks) {
+            ambiguous.push_back(i);
+            toEmbed.push_back(i);
+        }
+    }
+
+    // One batch for all crops of this frame
+    embeddings.assign(detectionCount, std::vector<float>());
+    if (!toEmbed.empty()) {
+        std::vector<cv::Rect> boxes;
+        for (size_t i : toEmbed) boxes.push_back(frame.detections[i]);
+        std::vector<std::vector<float>> computed = embedder ? embedder(frame.original, boxes)
+                                                            : ReIDModel::getInstance().embed(frame.original, boxes);
+        if (computed.size() == toEmbed.size()) {
+            for (size_t k = 0; k < toEmbed.size(); ++k) {
+                embeddings[toEmbed[k]] = std::move(computed[k]);
+            }
+        } else if (!embeddingCountWarned) {
+            // Without embeddings the frame is matched by IoU alone
+            LOG_WARNING("Expected %zu embeddings, got %zu; matching by IoU only where this happens",
+                        toEmbed.size(), computed.size());
+            embeddingCountWarned = true;
+        }
+    }
+
+    // Ambiguous detections against the tracks still free, by overlap and appearance
+    std::vector<size_t> freeTracks;
+    for (size_t j = 0; j < columns.size(); ++j) {
+        if (!trackTaken[j]) freeTracks.push_back(j);
+    }
+    if (!ambiguous.empty() && !freeTracks.empty()) {
+        // Where a lost track may be re-acquired without overlap: around its predicted box,
+        // by a reach growing with the frames it has been missing
+        std::vector<cv::Point2d> expectedCenter(freeTracks.size());
+        std::vector<double> reach(freeTracks.size(), -1.0);
+        for (size_t c = 0; c < freeTracks.size(); ++c) {
+            const Track& track = *columns[freeTracks[c]];
+            if (track.timeSinceUpdate <= 1) continue;
+            cv::Rect predicted = predictBox(trajectories.view(track.trajectorySlot), frame.frameIndex);
+            if (predicted.area() <= 0) predicted = track.rect;
+            expectedCenter[c] = cv::Point2d(predicted.x + predicted.width / 2.0, predicted.y + predicted.height / 2.0);
+            reach[c] = maxDisplacement * std::max(predicted.width, predicted.height) * (track.timeSinceUpdate - 1);
+        }
+
+        std::vector<std::vector<double>> cost(ambiguous.size(), std::vector<double>(freeTracks.size(), ASSIGNMENT_INFEASIBLE));
+        for (size_t r = 0; r < ambiguous.size(); ++r) {
+            const std::vector<float>& embedding = embeddings[ambiguous[r]];
+            for (size_t c = 0; c < freeTracks.size(); ++c) {
+                const Track& track = *columns[freeTracks[c]];
+                double iouDistance = 1.0 - overlap[ambiguous[r]][freeTracks[c]];
+                bool overlaps = overlap[ambiguous[r]][freeTracks[c]] > iouThreshold;
+                if (embedding.empty() || track.gallery.empty()) {
+                    if (overlaps) cost[r][c] = iouDistance;
+                    continue;
+                }
+                if (!overlaps) {
+                    const cv::Rect& box = frame.detections[ambiguous[r]];
+                    double dx = box.x + box.width / 2.0 - expectedCenter[c].x;
+                    double dy = box.y + box.height / 2.0 - expectedCenter[c].y;
+                    if (reach[c] < 0.0 || std::hypot(dx, dy) > reach[c]) continue;
+                }
+                double appearance = track.gallery.distance(embedding);
+                if (overlaps || appearance <= maxDistance) {
+                    cost[r][c] = (1.0 - appearanceWeight) * iouDistance + appearanceWeight * appearance;
+                }
+            }
+        }
+
+        std::vector<int> solution = solveAssignment(cost);
+        for (size_t r = 0; r < ambiguous.size(); ++r) {
+            if (solution[r] >= 0) {
+                assigned[ambiguous[r]] = static_cast<int>(freeTracks[solution[r]]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < detectionCount; ++i) {
+        if (assigned[i] < 0) {
+            unassignedDetections.push_back(static_cast<int>(i));
+            continue;
+        }
+        Track& track = *columns[assigned[i]];
+        track.update(frame.detections[i]);
+        if (!embeddings[i].empty()) {
+            track.addEmbedding(std::move(embeddings[i]));
+        }
+        frame.trackIDs[i] = track.trackId;
+    }
+}
+
+TrajectoryView Tracker::getTrajectory(int trackId) const {
+    auto track = tracks.find(trackId);
+    return track == tracks.end() ? TrajectoryView() : trajectories.view(track->second.trajectorySlot);
+}
+
 float Tracker::calculateIoU(const cv::Rect& box1, const cv::Rect& box2) {
     int x1 = std::max(box1.x, box2.x);
     int y1 = std::max(box1.y, box2.y);
@@ -119,13 +414,124 @@ float Tracker::calculateIoU(const cv::Rect& box1, const cv::Rect& box2) {
     return intersectionArea / unionArea;
 }
 
+bool Tracker::hasMissedTracks() const {
+    for (const auto& track : tracks) {
+        if (track.second.timeSinceUpdate > 0) return true;
+    }
+    return false;
+}
+
+cv::Rect Tracker::predictBox(const TrajectoryView& trajectory, int64_t frameIndex) {
+    if (trajectory.empty()) return cv::Rect();
+    const TrajectoryPoint& last = trajectory.back();
+    if (trajectory.size() < 2) return last.box;
+    const TrajectoryPoint& previous = trajectory[trajectory.size() - 2];
+
+    int64_t span = last.frameIndex - previous.frameIndex;
+    int64_t ahead = frameIndex - last.frameIndex;
+    if (previous.frameIndex < 0 || span <= 0 || ahead <= 0) return last.box;
+
+    // Centers move at the last observed rate; the size is kept
+    double steps = static_cast<double>(ahead) / static_cast<double>(span);
+    double dx = (last.box.x + last.box.width / 2.0) - (previous.box.x + previous.box.width / 2.0);
+    double dy = (last.box.y + last.box.height / 2.0) - (previous.box.y + previous.box.height / 2.0);
+    return cv::Rect(last.box.x + static_cast<int>(std::lround(dx * steps)),
+                    last.box.y + static_cast<int>(std::lround(dy * steps)), last.box.width, last.box.height);
+}
+
+std::vector<cv::Rect> Tracker::planTrackCrops(const std::vector<cv::Rect>& boxes, const cv::Size& frameSize,
+                                              double padding, int minSize) {
+    cv::Rect bounds(cv::Point(0, 0), frameSize);
+    std::vector<cv::Rect> crops;
+
+    for (const cv::Rect& box : boxes) {
+        int side = static_cast<int>(std::lround(std::max(box.width, box.height) * (1.0 + 2.0 * padding)));
+        side = std::max(side, minSize);
+
+        // Shift square crops back inside the frame before clipping, so they stay square where possible
+        cv::Rect crop(box.x + box.width / 2 - side / 2, box.y + box.height / 2 - side / 2, side, side);
+        crop.x = std::clamp(crop.x, 0, std::max(0, bounds.width - side));
+        crop.y = std::clamp(crop.y, 0, std::max(0, bounds.height - side));
+        crop &= bounds;
+        if (crop.area() > 0) {
+            crops.push_back(crop);
+        }
+    }
+
+    // Merge overlapping crops so no area is inferred twice
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (size_t i = 0; i < crops.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < crops.size(); ++j) {
+                if ((crops[i] & crops[j]).area() > 0) {
+                    crops[i] |= crops[j];
+                    crops.erase(crops.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    long long pixels = 0;
+    for (const cv::Rect& crop : crops) {
+        pixels += crop.area();
+    }
+    if (pixels * 2 >= static_cast<long long>(bounds.area())) {
+        crops.clear();
+    }
+    return crops;
+}
+
+bool Tracker::prepareTrackRegions(Frame& frame) {
+    cv::Rect bounds(cv::Point(0, 0), frame.processed.size());
+
+    // Cover the span from where each track was last seen to where it should be now
+    std::vector<cv::Rect> boxes;
+    boxes.reserve(tracks.size());
+    for (const auto& track : tracks) {
+        cv::Rect predicted = predictBox(trajectories.view(track.second.trajectorySlot), frame.frameIndex);
+        boxes.push_back(predicted.area() > 0 ? (track.second.rect | predicted) : track.second.rect);
+    }
+
+    std::vector<cv::Rect> crops = planTrackCrops(boxes, bounds.size(), Config::getROIPadding(), Config::getROIMinSize());
+    if (crops.empty()) {
+        return false;
+    }
+    long long pixels = 0;
+    for (const cv::Rect& crop : crops) {
+        pixels += crop.area();
+    }
+
+    frame.regions.clear();
+    for (const cv::Rect& crop : crops) {
+        frame.regions.push_back(InferenceRegion{crop});
+    }
+
+    ONNXModel& model = ONNXModel::getInstance();
+    std::vector<int64_t> dims = QualityController::getInstance().inputDims(model.getInputNodeDims());
+    frame.onnx_input = ImageProcessor::preprocessRegionsForONNX(frame.processed, frame.regions, Config::getLetterbox(),
+                                                                frame.inputBlob, model.getMemoryInfo(), dims,
+                                                                model.getInputFormat());
+    LOG_DEBUG("[Tracker] ROI inference on %zu crops, %.1f%% of the frame",
+              crops.size(), 100.0 * pixels / bounds.area());
+    return true;
+}
+
 // Track class implementation
 Tracker::Track::Track(const cv::Rect& initialRect, int id) 
-    : rect(initialRect), trackId(id), timeSinceUpdate(0) {}
+    : rect(initialRect), trackId(id), timeSinceUpdate(0), framesSinceEmbedding(0),
+      gallery(static_cast<size_t>(Config::getReIDGallerySize())), trajectorySlot(-1) {}
 
 void Tracker::Track::predict() {
     // Simple prediction: assume the object stays in the same place
     timeSinceUpdate++;
+    framesSinceEmbedding++;
+}
+
+void Tracker::Track::addEmbedding(std::vector<float> embedding) {
+    gallery.add(std::move(embedding));
+    framesSinceEmbedding = 0;
 }
 
 void Tracker::Track::update(const cv::Rect& newRect) {
@@ -7,8 +7,15 @@
 #define TRACKER_H
 
 #include "frame.h"
+#include "reid_model.h"
 #include "thread_safe_queue.h"
+#include "track_results.h"
+#include "trajectory_arena.h"
 #include <opencv2/opencv.hpp>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
 #include <unordered_map>
 
 /**
@@ -28,10 +35,28 @@ public:
      * @brief Main processing loop for the Tracker.
      *
      * This method continuously takes frames from the input queue, processes them for tracking,
-     * and places the results in the output queue.
+     * and places the results in the output queue. Up to inference_in_flight frames are
+     * inferred in the background while older frames are associated, in stream order.
      */
     void run();
 
+    /**
+     * @brief Run the model on a frame prepared for full-frame or tiled inference.
+     *
+     * Stateless, so it may run for several frames at once. Frames with known or
+     * reused detections and ROI frames are left to associate().
+     * @param frame Frame with onnx_input; receives detections.
+     */
+    void detect(Frame& frame);
+
+    /**
+     * @brief Finish detection where it depends on the tracks, then update the tracks.
+     *
+     * Keeps state across frames, so frames must be passed one at a time in stream order.
+     * @param frame Frame after detect(); receives detections and track IDs.
+     */
+    void associate(Frame& frame);
+
     /**
      * @brief Retrieve a processed frame with tracking information.
      * @param frame Reference to a Frame object where the processed frame will be stored.
@@ -39,10 +64,110 @@ public:
      */
     bool getProcessedFrame(Frame& frame);
 
+    /**
+     * @brief Update existing tracks with new frame information.
+     *
+     * Called by run() for every frame; also used directly by offline evaluation tools.
+     * @param frame Frame containing new detection information.
+     */
+    void updateTracks(Frame& frame);
+
+    /**
+     * @brief View the recent states of a track without copying them.
+     *
+     * The view is valid until the next updateTracks(), so call this from the thread running the tracker.
+     * @param trackId Track to query.
+     * @return TrajectoryView Observed states, oldest first; empty if the track does not exist.
+     */
+    TrajectoryView getTrajectory(int trackId) const;
+
+    /**
+     * @brief Visit the trajectories of all live tracks without copying them.
+     * @param visit Called as visit(trackId, const TrajectoryView&) for every track.
+     */
+    template<typename Visitor>
+    void forEachTrajectory(Visitor&& visit) const {
+        for (const auto& track : tracks) {
+            visit(track.first, trajectories.view(track.second.trajectorySlot));
+        }
+    }
+
+    /**
+     * @brief Publish the tracks of every associated frame to a shared-memory results ring.
+     * @param writer Ring to publish to, or nullptr to stop publishing; must outlive the tracker's use of it.
+     */
+    void setResultsWriter(TrackResultsWriter* writer) { resultsWriter = writer; }
+
+    /// Computes one L2-normalized embedding per box of an image.
+    using Embedder = std::function<std::vector<std::vector<float>>(const cv::Mat&, const std::vector<cv::Rect>&)>;
+
+    /**
+     * @brief Match by appearance with a custom embedding source instead of the ReID model.
+     *
+     * Frames for which it returns a different number of embeddings than boxes are matched by IoU only.
+     * @param embed Embedding source, e.g. for tests; an empty function restores the ReID model.
+     */
+    void setEmbedder(Embedder embed) { embedder = std::move(embed); }
+
+    /**
+     * @brief Check whether a track went unmatched on the last frame passed to updateTracks().
+     *
+     * After an ROI frame this means a track left its crop, so the next frame is scanned whole.
+     * @return bool True if any live track was not updated.
+     */
+    bool hasMissedTracks() const;
+
+    /**
+     * @brief Extrapolate a track's box to a frame at constant velocity.
+     *
+     * The velocity comes from the two newest points of the trajectory.
+     * @param trajectory Observed states of the track.
+     * @param frameIndex Frame to predict the box for.
+     * @return cv::Rect The predicted box; the newest observed box if the motion is unknown, empty if nothing was observed.
+     */
+    static cv::Rect predictBox(const TrajectoryView& trajectory, int64_t frameIndex);
+
+    /**
+     * @brief Plan square crops around boxes for ROI inference.
+     *
+     * Each box is padded on every side by a fraction of its longer side, grown to at
+     * least minSize and shifted inside the frame. Overlapping crops are merged.
+     * @param boxes Areas to cover.
+     * @param frameSize Size of the frame.
+     * @param padding Padding per side as a fraction of the box's longer side.
+     * @param minSize Minimum crop side length in pixels.
+     * @return std::vector<cv::Rect> The crops; empty if there are no boxes or the crops cover half the frame or more.
+     */
+    static std::vector<cv::Rect> planTrackCrops(const std::vector<cv::Rect>& boxes, const cv::Size& frameSize,
+                                                double padding, int minSize);
+
 private:
     ThreadSafeQueue<Frame>& inputQueue; ///< Reference to the input queue
     ThreadSafeQueue<Frame>& outputQueue; ///< Reference to the output queue
 
+    /**
+     * @struct PendingFrame
+     * @brief A frame taken by run() whose inference may still be running.
+     */
+    struct PendingFrame {
+        Frame frame;
+        std::future<std::vector<cv::Rect>> detections; ///< Result of the background inference, if one was started
+        std::chrono::steady_clock::time_point dispatched; ///< When the inference was started
+    };
+
+    std::deque<PendingFrame> inFlight; ///< Frames taken by run(), oldest first; a deque keeps them in place
+
+    /**
+     * @brief Queue a frame in inFlight and start its inference if it needs one.
+     * @param frame Frame taken from the input queue.
+     */
+    void dispatch(Frame&& frame);
+
+    /**
+     * @brief Wait for the oldest frame's inference, associate it and pass it on.
+     */
+    void completeOldest();
+
     /**
      * @class Track
      * @brief Represents a single tracked object.
@@ -52,7 +177,7 @@ private:
         /**
          * @brief Default constructor for Track.
          */
-        Track() : rect(0, 0, 0, 0), trackId(-1), timeSinceUpdate(0) {}
+        Track() : rect(0, 0, 0, 0), trackId(-1), timeSinceUpdate(0), framesSinceEmbedding(0), trajectorySlot(-1) {}
 
         /**
          * @brief Constructor for Track with initial bounding box and ID.
@@ -72,19 +197,35 @@ private:
          */
         void update(const cv::Rect& newRect);
 
+        /**
+         * @brief Store an appearance embedding of the track.
+         * @param embedding L2-normalized embedding of the matched detection.
+         */
+        void addEmbedding(std::vector<float> embedding);
+
         cv::Rect rect; ///< Current bounding box of the tracked object
         int trackId; ///< Unique identifier for the track
         int timeSinceUpdate; ///< Time elapsed since the last update
+        int framesSinceEmbedding; ///< Frames since the gallery last received an embedding
+        EmbeddingGallery gallery; ///< Recent appearance embeddings, filled only with re-identification
+        int trajectorySlot; ///< Slot of the track's history in the trajectory arena
     };
 
     std::unordered_map<int, Track> tracks; ///< Map of active tracks
+    std::vector<cv::Rect> lastDetections; ///< Detections of the previous frame, reused for unchanged frames
+    std::vector<float> lastScores; ///< Confidences of lastDetections
     int nextTrackID; ///< Next available track ID
+    TrajectoryArena trajectories; ///< History rings of the live tracks
+    Embedder embedder; ///< Custom embedding source; empty to use the ReID model
+    bool embeddingCountWarned = false; ///< Whether a wrong number of embeddings was already reported
+    TrackResultsWriter* resultsWriter = nullptr; ///< Receives each frame's tracks, if set
+    std::vector<TrackRecord> resultRecords; ///< Reused buffer for publishing a frame's tracks
 
     /**
-     * @brief Update existing tracks with new frame information.
-     * @param frame Frame containing new detection information.
+     * @brief Publish the matched detections of a frame to the results ring.
+     * @param frame Frame after updateTracks().
      */
-    void updateTracks(Frame& frame);
+    void publishResults(const Frame& frame);
 
     /**
      * @brief Calculate the Intersection over Union (IoU) between two bounding boxes.
@@ -93,6 +234,38 @@ private:
      * @return float IoU value between 0 and 1.
      */
     float calculateIoU(const cv::Rect& box1, const cv::Rect& box2);
+
+    /**
+     * @brief Match detections to tracks by IoU, falling back to appearance where IoU is not conclusive.
+     *
+     * A detection and a track that overlap only each other are matched without an embedding.
+     * Detections overlapping several tracks, overlapped by a track with other candidates, or
+     * overlapping nothing while lost tracks exist are embedded in one batch and assigned by a
+     * cost mixing IoU and cosine distance. A detection may take a track it does not overlap only
+     * if the track was lost before this frame and the detection lies near its predicted box.
+     * @param frame Frame with detections; receives the track IDs of matched detections.
+     * @param unassignedDetections Receives the indices of detections that start new tracks.
+     * @param embeddings Receives the embedding of each detection, empty where none was computed.
+     */
+    void matchWithAppearance(Frame& frame, std::vector<int>& unassignedDetections,
+                             std::vector<std::vector<float>>& embeddings);
+
+    /**
+     * @brief Build a batched model input from padded crops around the current tracks.
+     *
+     * Each crop covers both the track's last box and its box predicted for this
+     * frame, so fast movers stay inside. Nothing is built when planTrackCrops()
+     * finds no crops.
+     * @param frame Frame to prepare; receives onnx_input and one region per crop.
+     * @return bool True if the input was built, false if the whole frame should be inferred.
+     */
+    bool prepareTrackRegions(Frame& frame);
+
+    /**
+     * @brief Run the model on the frame's onnx_input and regions.
+     * @param frame Frame to detect; receives detections and hasDetections on success.
+     */
+    void runModel(Frame& frame);
 };
 
 #endif // TRACKER_H
\ No newline at end of file
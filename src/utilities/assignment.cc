@@ -0,0 +1,75 @@
+#include "assignment.h"
+#include <cstddef>
+#include <limits>
+
+std::vector<int> solveAssignment(const std::vector<std::vector<double>>& cost) {
+    size_t rows = cost.size();
+    size_t cols = rows ? cost[0].size() : 0;
+    std::vector<int> result(rows, -1);
+    if (rows == 0 || cols == 0) return result;
+
+    // The potential-based Hungarian method below needs rows <= columns
+    bool transposed = rows > cols;
+    size_t n = transposed ? cols : rows;
+    size_t m = transposed ? rows : cols;
+    auto at = [&](size_t i, size_t j) {
+        return transposed ? cost[j - 1][i - 1] : cost[i - 1][j - 1];
+    };
+
+    const double INF = std::numeric_limits<double>::infinity();
+    std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0);
+    std::vector<size_t> match(m + 1, 0), way(m + 1, 0);
+
+    for (size_t i = 1; i <= n; ++i) {
+        match[0] = i;
+        size_t j0 = 0;
+        std::vector<double> minv(m + 1, INF);
+        std::vector<bool> used(m + 1, false);
+
+        do {
+            used[j0] = true;
+            size_t i0 = match[j0];
+            size_t j1 = 0;
+            double delta = INF;
+            for (size_t j = 1; j <= m; ++j) {
+                if (used[j]) continue;
+                double cur = at(i0, j) - u[i0] - v[j];
+                if (cur < minv[j]) {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if (minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for (size_t j = 0; j <= m; ++j) {
+                if (used[j]) {
+                    u[match[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (match[j0] != 0);
+
+        // Walk back along the augmenting path
+        do {
+            size_t j1 = way[j0];
+            match[j0] = match[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (size_t j = 1; j <= m; ++j) {
+        if (match[j] == 0 || at(match[j], j) >= ASSIGNMENT_INFEASIBLE) continue;
+        if (transposed) {
+            result[j - 1] = static_cast<int>(match[j] - 1);
+        } else {
+            result[match[j] - 1] = static_cast<int>(j - 1);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file assignment.h
+ * @brief Minimum-cost bipartite assignment (Hungarian algorithm)
+ */
+
+#pragma once
+
+#include <vector>
+
+/**
+ * @brief Cost used to mark a row/column pair that must not be assigned
+ */
+constexpr double ASSIGNMENT_INFEASIBLE = 1e9;
+
+/**
+ * @brief Solve the rectangular minimum-cost assignment problem
+ *
+ * Each row is assigned to at most one column and vice versa, minimizing the
+ * total cost. Pairs whose cost is ASSIGNMENT_INFEASIBLE or more are never
+ * returned as assigned.
+ *
+ * @param cost Cost matrix indexed as cost[row][column]; all rows must have the same length
+ * @return For every row, the assigned column or -1
+ */
+std::vector<int> solveAssignment(const std::vector<std::vector<double>>& cost);
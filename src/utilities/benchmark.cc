@@ -0,0 +1,154 @@
+#include "benchmark.h"
+#include "logger.h"
+#include "version.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+#include <sys/resource.h>
+
+void BenchmarkReport::addPass(int frames, double seconds) {
+    passes.push_back({frames, seconds});
+}
+
+void BenchmarkReport::addLatency(double milliseconds) {
+    latencies.push_back(milliseconds);
+}
+
+void BenchmarkReport::setStageBusyTime(const std::string& stage, long long nanoseconds) {
+    stageBusyTime[stage] = nanoseconds;
+}
+
+double BenchmarkReport::latencyPercentile(double p) const {
+    if (latencies.empty()) return 0.0;
+
+    std::vector<double> sorted(latencies);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Linear interpolation between closest ranks
+    double rank = std::clamp(p, 0.0, 100.0) / 100.0 * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(std::floor(rank));
+    size_t upper = static_cast<size_t>(std::ceil(rank));
+    double fraction = rank - lower;
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+}
+
+int BenchmarkReport::totalFrames() const {
+    int frames = 0;
+    for (const auto& pass : passes) frames += pass.frames;
+    return frames;
+}
+
+double BenchmarkReport::totalSeconds() const {
+    double seconds = 0.0;
+    for (const auto& pass : passes) seconds += pass.seconds;
+    return seconds;
+}
+
+double BenchmarkReport::peakRSSMegabytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    // ru_maxrss is reported in bytes on macOS
+    return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+    // ... and in kilobytes on Linux
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+}
+
+std::string BenchmarkReport::escapeJSON(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            // Control characters may not appear raw inside a JSON string
+            char escaped[7];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string BenchmarkReport::toJSON(const BenchmarkOptions& options) const {
+    int frames = totalFrames();
+    double seconds = totalSeconds();
+    double wallNs = seconds * 1e9;
+
+    double meanLatency = 0.0;
+    for (double l : latencies) meanLatency += l;
+    if (!latencies.empty()) meanLatency /= latencies.size();
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"version\": \"" << OBJECT_TRACKING_VERSION << "\",\n";
+    json << "  \"video\": \"" << escapeJSON(options.videoPath) << "\",\n";
+    json << "  \"warmup_frames\": " << options.warmupFrames << ",\n";
+    json << "  \"repeat\": " << options.repeat << ",\n";
+    json << "  \"frames\": " << frames << ",\n";
+    json << "  \"wall_time_s\": " << seconds << ",\n";
+    json << "  \"fps\": " << (seconds > 0 ? frames / seconds : 0.0) << ",\n";
+
+    json << "  \"passes\": [";
+    for (size_t i = 0; i < passes.size(); ++i) {
+        const auto& pass = passes[i];
+        json << (i ? ", " : "") << "{\"frames\": " << pass.frames
+             << ", \"wall_time_s\": " << pass.seconds
+             << ", \"fps\": " << (pass.seconds > 0 ? pass.frames / pass.seconds : 0.0) << "}";
+    }
+    json << "],\n";
+
+    json << "  \"stage_utilization\": {";
+    bool first = true;
+    for (const auto& stage : stageBusyTime) {
+        json << (first ? "" : ", ") << "\"" << stage.first << "\": "
+             << (wallNs > 0 ? stage.second / wallNs : 0.0);
+        first = false;
+    }
+    json << "},\n";
+
+    json << "  \"stage_avg_ms\": {";
+    first = true;
+    for (const auto& stage : stageBusyTime) {
+        json << (first ? "" : ", ") << "\"" << stage.first << "\": "
+             << (frames > 0 ? stage.second / 1e6 / frames : 0.0);
+        first = false;
+    }
+    json << "},\n";
+
+    json << "  \"latency_ms\": {"
+         << "\"min\": " << latencyPercentile(0)
+         << ", \"mean\": " << meanLatency
+         << ", \"p50\": " << latencyPercentile(50)
+         << ", \"p90\": " << latencyPercentile(90)
+         << ", \"p95\": " << latencyPercentile(95)
+         << ", \"p99\": " << latencyPercentile(99)
+         << ", \"max\": " << latencyPercentile(100) << "},\n";
+
+    json << "  \"peak_rss_mb\": " << peakRSSMegabytes() << "\n";
+    json << "}\n";
+
+    return json.str();
+}
+
+void BenchmarkReport::logSummary() const {
+    int frames = totalFrames();
+    double seconds = totalSeconds();
+
+    LOG_INFO("Benchmark results (%d frames in %.2f s):", frames, seconds);
+    LOG_INFO("   Throughput: %.2f FPS", seconds > 0 ? frames / seconds : 0.0);
+    for (const auto& stage : stageBusyTime) {
+        LOG_INFO("   %s utilization: %.1f%%", stage.first.c_str(),
+                 seconds > 0 ? stage.second / (seconds * 1e9) * 100.0 : 0.0);
+    }
+    LOG_INFO("   Latency p50/p95/p99: %.2f / %.2f / %.2f ms",
+             latencyPercentile(50), latencyPercentile(95), latencyPercentile(99));
+    LOG_INFO("   Peak RSS: %.1f MB", peakRSSMegabytes());
+}
@@ -0,0 +1,103 @@
+/**
+ * @file benchmark.h
+ * @brief Statistics collection and reporting for the offline benchmark mode
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+/**
+ * @struct BenchmarkOptions
+ * @brief Command line options controlling a benchmark run
+ */
+struct BenchmarkOptions {
+    bool enabled = false;       /**< True when --benchmark was given */
+    std::string videoPath;      /**< Video to process */
+    int warmupFrames = 0;       /**< Frames processed before measuring starts */
+    int repeat = 1;             /**< Number of measured passes over the video */
+    std::string outputPath;     /**< JSON summary destination (stdout if empty, logging then goes to stderr) */
+};
+
+/**
+ * @class BenchmarkReport
+ * @brief Accumulates throughput, stage utilization and latency for a benchmark run
+ */
+class BenchmarkReport {
+public:
+    /**
+     * @brief Record the result of one measured pass over the video
+     * @param frames Number of frames processed in the pass
+     * @param seconds Wall time of the pass in seconds
+     */
+    void addPass(int frames, double seconds);
+
+    /**
+     * @brief Record the end-to-end latency of one frame
+     * @param milliseconds Time from frame acquisition to tracking result
+     */
+    void addLatency(double milliseconds);
+
+    /**
+     * @brief Record the busy time of a pipeline stage during the measured window
+     * @param stage Name of the stage
+     * @param nanoseconds Total time the stage spent processing frames
+     */
+    void setStageBusyTime(const std::string& stage, long long nanoseconds);
+
+    /**
+     * @brief Get a latency percentile
+     * @param p Percentile in the range [0, 100]
+     * @return Latency in milliseconds, or 0 if no samples were recorded
+     */
+    double latencyPercentile(double p) const;
+
+    /**
+     * @brief Get the number of frames across all measured passes
+     * @return Total frame count
+     */
+    int totalFrames() const;
+
+    /**
+     * @brief Get the wall time across all measured passes
+     * @return Total time in seconds
+     */
+    double totalSeconds() const;
+
+    /**
+     * @brief Get the peak resident set size of the process
+     * @return Peak RSS in megabytes
+     */
+    static double peakRSSMegabytes();
+
+    /**
+     * @brief Serialize the report as a JSON object
+     * @param options Options the benchmark was run with
+     * @return JSON text
+     */
+    std::string toJSON(const BenchmarkOptions& options) const;
+
+    /**
+     * @brief Log a human-readable summary of the report
+     */
+    void logSummary() const;
+
+    /**
+     * @brief Escape text for use inside a JSON string
+     * @param s Text to escape
+     * @return The text with quotes, backslashes and control characters escaped
+     */
+    static std::string escapeJSON(const std::string& s);
+
+private:
+    struct Pass {
+        int frames;
+        double seconds;
+    };
+
+    std::vector<Pass> passes;                       ///< Measured passes
+    std::vector<double> latencies;                  ///< Per-frame latency in ms
+    std::map<std::string, long long> stageBusyTime; ///< Busy time per stage in ns
+};
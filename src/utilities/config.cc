@@ -3,6 +3,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 
 // Trim function
@@ -12,6 +13,14 @@ static inline std::string trim(const std::string &s) {
     return (wsback <= wsfront ? std::string() : std::string(wsfront, wsback));
 }
 
+// Parse a boolean option value
+static inline bool parseBool(const std::string &s) {
+    std::string lower = s;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                [](unsigned char c){ return std::tolower(c); });
+    return lower == "true" || lower == "1" || lower == "yes";
+}
+
 // New function to remove comments
 static inline std::string removeComment(const std::string &s) {
     size_t pos = s.find(';');
@@ -34,8 +43,8 @@ bool Config::loadFromFile(const std::string& filename) {
     bool sourceSpecified = false;
     bool videoPathSpecified = false;
 
-    // Set default log level mask
-    logLevelMask = LOG_LV_ERROR | LOG_LV_WARNING | LOG_LV_INFO;
+    // Runtime settings start from their defaults and are published once the file is valid
+    RuntimeSettings runtimeNext;
 
     while (std::getline(file, line)) {
         std::istringstream is_line(line);
@@ -51,7 +60,9 @@ bool Config::loadFromFile(const std::string& filename) {
                 value.erase(0, value.find_first_not_of(" \t"));
                 value.erase(value.find_last_not_of(" \t") + 1);
 
-                if (section == "Model") {
+                if (parseRuntimeSetting(section, key, value, runtimeNext)) {
+                    // Thresholds, detection interval and log level may change at runtime
+                } else if (section == "Model") {
                     if (key == "path") {
                         if (value.substr(value.length() - 5) == ".onnx") {
                             modelPath = value;
@@ -59,7 +70,10 @@ bool Config::loadFromFile(const std::string& filename) {
                             throw std::runtime_error("Invalid model path: File must have .onnx extension");
                         }
                     }
-                    else if (key == "confidence_threshold") confidenceThreshold = std::stof(value);
+                    else if (key == "input_width") inputWidth = std::stoi(trim(removeComment(value)));
+                    else if (key == "input_height") inputHeight = std::stoi(trim(removeComment(value)));
+                    else if (key == "letterbox") letterbox = parseBool(trim(removeComment(value)));
+                    else if (key == "warmup_runs") warmupRuns = std::stoi(trim(removeComment(value)));
                 } else if (section == "Input") {
                     if (key == "source") {
                         sourceSpecified = true;
@@ -73,6 +87,18 @@ bool Config::loadFromFile(const std::string& filename) {
                         } else if (lowerValue == "video") {
                             inputSource = InputSource::VIDEO;
                             LOG_INFO("Input source set to VIDEO");
+                        } else if (lowerValue == "raw") {
+                            inputSource = InputSource::RAW;
+                            LOG_INFO("Input source set to RAW");
+                        } else if (lowerValue == "shm") {
+                            inputSource = InputSource::SHM;
+                            LOG_INFO("Input source set to SHM");
+                        } else if (lowerValue == "image_sequence") {
+                            inputSource = InputSource::IMAGE_SEQUENCE;
+                            LOG_INFO("Input source set to IMAGE_SEQUENCE");
+                        } else if (lowerValue == "synthetic") {
+                            inputSource = InputSource::SYNTHETIC;
+                            LOG_INFO("Input source set to SYNTHETIC");
                         } else {
                             LOG_WARNING("Invalid input source: '%s'. Using default (VIDEO).", trimmedValue.c_str());
                             inputSource = InputSource::VIDEO;
@@ -85,23 +111,120 @@ bool Config::loadFromFile(const std::string& filename) {
                         } else {
                             LOG_WARNING("Empty video path specified.");
                         }
+                    } else if (key == "image_dir") {
+                        imageDirectory = trim(removeComment(value));
+                    } else if (key == "decode_threads") {
+                        decodeThreads = std::stoi(trim(removeComment(value)));
+                    } else if (key == "raw_path") {
+                        rawPath = trim(removeComment(value));
+                    } else if (key == "raw_format") {
+                        rawFormat = trim(removeComment(value));
+                    } else if (key == "raw_width") {
+                        rawWidth = std::stoi(trim(removeComment(value)));
+                    } else if (key == "raw_height") {
+                        rawHeight = std::stoi(trim(removeComment(value)));
+                    } else if (key == "raw_fps") {
+                        rawFPS = std::stod(trim(removeComment(value)));
+                    } else if (key == "shm_name") {
+                        shmName = trim(removeComment(value));
+                    } else if (key == "shm_timeout_ms") {
+                        shmTimeout = std::stoi(trim(removeComment(value)));
+                    } else if (key == "low_latency") {
+                        lowLatency = parseBool(trim(removeComment(value)));
                     }
                 } else if (section == "Tracking") {
-                    if (key == "iou_threshold") iouThreshold = std::stof(value);
-                    else if (key == "max_frames_to_skip") maxFramesToSkip = std::stoi(value);
-                } else if (section == "Logging") {
-                    if (key == "debug") {
-                        std::string trimmedValue = trim(removeComment(value));
-                        std::transform(trimmedValue.begin(), trimmedValue.end(), trimmedValue.begin(),
+                    if (key == "trajectory_length") trajectoryLength = std::stoi(trim(removeComment(value)));
+                } else if (section == "Tiling") {
+                    value = trim(removeComment(value));
+                    if (key == "enabled") tilingEnabled = parseBool(value);
+                    else if (key == "tile_size") tileSize = std::stoi(value);
+                    else if (key == "overlap") tileOverlap = std::stod(value);
+                    else if (key == "full_frame") tileFullFrame = parseBool(value);
+                    else if (key == "max_batch") tileMaxBatch = std::stoi(value);
+                } else if (section == "ROI") {
+                    value = trim(removeComment(value));
+                    if (key == "enabled") roiEnabled = parseBool(value);
+                    else if (key == "full_scan_interval") roiFullScanInterval = std::stoi(value);
+                    else if (key == "padding") roiPadding = std::stod(value);
+                    else if (key == "min_size") roiMinSize = std::stoi(value);
+                } else if (section == "Pipeline") {
+                    value = trim(removeComment(value));
+                    if (key == "scheduler") {
+                        std::string lowerValue = value;
+                        std::transform(lowerValue.begin(), lowerValue.end(), lowerValue.begin(),
                                     [](unsigned char c){ return std::tolower(c); });
-                        if (trimmedValue == "true" || trimmedValue == "1" || trimmedValue == "yes") {
-                            logLevelMask |= LOG_LV_DEBUG;
-                            LOG_INFO("Debug logging enabled");
+                        if (lowerValue == "pool") {
+                            taskScheduler = true;
+                        } else if (lowerValue == "threads") {
+                            taskScheduler = false;
                         } else {
-                            logLevelMask &= ~LOG_LV_DEBUG;
-                            LOG_INFO("Debug logging disabled");
+                            LOG_WARNING("Invalid scheduler: '%s'. Using default (threads).", value.c_str());
+                            taskScheduler = false;
                         }
                     }
+                    else if (key == "workers") schedulerWorkers = std::stoi(value);
+                    else if (key == "max_in_flight") schedulerMaxInFlight = std::stoi(value);
+                    else if (key == "inference_in_flight") inferenceInFlight = std::stoi(value);
+                } else if (section == "Quality") {
+                    value = trim(removeComment(value));
+                    if (key == "enabled") qualityEnabled = parseBool(value);
+                    else if (key == "target_fps") qualityTargetFPS = std::stod(value);
+                    else if (key == "latency_budget_ms") qualityLatencyBudget = std::stod(value);
+                    else if (key == "margin") qualityMargin = std::stod(value);
+                    else if (key == "windows") qualityWindows = std::stoi(value);
+                    else if (key == "max_detection_interval") qualityMaxDetectionInterval = std::stoi(value);
+                    else if (key == "min_input_scale") qualityMinInputScale = std::stod(value);
+                    else if (key == "max_tile_scale") qualityMaxTileScale = std::stod(value);
+                } else if (section == "ReID") {
+                    value = trim(removeComment(value));
+                    if (key == "enabled") reidEnabled = parseBool(value);
+                    else if (key == "model_path") reidModelPath = value;
+                    else if (key == "gallery_size") reidGallerySize = std::stoi(value);
+                    else if (key == "appearance_weight") reidAppearanceWeight = std::stod(value);
+                    else if (key == "max_distance") reidMaxDistance = std::stod(value);
+                    else if (key == "max_displacement") reidMaxDisplacement = std::stod(value);
+                    else if (key == "refresh_interval") reidRefreshInterval = std::stoi(value);
+                } else if (section == "MotionGate") {
+                    value = trim(removeComment(value));
+                    if (key == "enabled") motionGateEnabled = parseBool(value);
+                    else if (key == "width") motionGateWidth = std::stoi(value);
+                    else if (key == "threshold") motionGateThreshold = std::stod(value);
+                    else if (key == "refresh_interval") motionGateRefresh = std::stoi(value);
+                } else if (section == "Synthetic") {
+                    value = trim(removeComment(value));
+                    if (key == "width") syntheticWidth = std::stoi(value);
+                    else if (key == "height") syntheticHeight = std::stoi(value);
+                    else if (key == "fps") syntheticFPS = std::stod(value);
+                    else if (key == "objects") syntheticObjects = std::stoi(value);
+                    else if (key == "frames") syntheticFrames = std::stoi(value);
+                    else if (key == "seed") syntheticSeed = static_cast<unsigned int>(std::stoul(value));
+                    else if (key == "inject_detections") injectGroundTruth = parseBool(value);
+                } else if (section == "Cache") {
+                    if (key == "detections_dir") detectionCacheDir = trim(removeComment(value));
+                } else if (section == "Output") {
+                    value = trim(removeComment(value));
+                    if (key == "video_path") outputPath = value;
+                    else if (key == "track_log") trackLogPath = value;
+                    else if (key == "fourcc") outputFourCC = value;
+                    else if (key == "fps") outputFPS = std::stod(value);
+                    else if (key == "every_n") outputEveryNth = std::stoi(value);
+                    else if (key == "only_detections") outputOnlyDetections = parseBool(value);
+                    else if (key == "queue_size") outputQueueSize = std::stoi(value);
+                    else if (key == "when_full") {
+                        if (value == "drop") outputDropWhenFull = true;
+                        else if (value == "block") outputDropWhenFull = false;
+                        else LOG_WARNING("Invalid when_full value: '%s'. Using default (drop).", value.c_str());
+                    }
+                } else if (section == "Reload") {
+                    value = trim(removeComment(value));
+                    if (key == "enabled") reloadEnabled = parseBool(value);
+                    else if (key == "interval_ms") reloadInterval = std::stoi(value);
+                } else if (section == "Results") {
+                    value = trim(removeComment(value));
+                    if (key == "enabled") resultsEnabled = parseBool(value);
+                    else if (key == "shm_name") resultsShmName = value;
+                    else if (key == "slots") resultsSlots = std::stoi(value);
+                    else if (key == "max_tracks") resultsMaxTracks = std::stoi(value);
                 }
             }
         }
@@ -127,5 +250,194 @@ bool Config::loadFromFile(const std::string& filename) {
         videoPath = "";
     }
 
+    if (inputSource == InputSource::IMAGE_SEQUENCE && imageDirectory.empty()) {
+        LOG_ERROR("Invalid configuration: Image sequence selected but no image_dir provided.");
+        return false;
+    }
+
+    if (inputSource == InputSource::SHM && (shmName.size() < 2 || shmName.front() != '/' || shmTimeout <= 0)) {
+        LOG_ERROR("Invalid configuration: shm_name must start with '/' and shm_timeout_ms must be positive.");
+        return false;
+    }
+
+    if (inputSource == InputSource::RAW && rawPath.empty()) {
+        LOG_ERROR("Invalid configuration: Raw source selected but no raw_path provided.");
+        return false;
+    }
+
+    if (inputSource == InputSource::SYNTHETIC &&
+        (syntheticWidth <= 0 || syntheticHeight <= 0 || syntheticObjects < 0)) {
+        LOG_ERROR("Invalid configuration: Synthetic source needs a positive size and object count.");
+        return false;
+    }
+
+    // YOLO-style models downsample by 32
+    if (inputWidth <= 0 || inputHeight <= 0 || inputWidth % 32 != 0 || inputHeight % 32 != 0) {
+        LOG_ERROR("Invalid configuration: Model input_width and input_height must be positive multiples of 32.");
+        return false;
+    }
+
+    if (warmupRuns < 0) {
+        LOG_ERROR("Invalid configuration: Model warmup_runs must not be negative.");
+        return false;
+    }
+
+    if (tilingEnabled && (tileSize <= 0 || tileOverlap < 0.0 || tileOverlap >= 1.0 || tileMaxBatch < 0)) {
+        LOG_ERROR("Invalid configuration: Tiling needs a positive tile_size and an overlap in [0, 1).");
+        return false;
+    }
+
+    if (roiEnabled && (roiFullScanInterval <= 0 || roiPadding < 0.0 || roiMinSize <= 0)) {
+        LOG_ERROR("Invalid configuration: ROI inference needs a positive full_scan_interval and min_size.");
+        return false;
+    }
+
+    if (trajectoryLength <= 0) {
+        LOG_ERROR("Invalid configuration: Tracking trajectory_length must be positive.");
+        return false;
+    }
+
+    if (schedulerWorkers < 0 || schedulerMaxInFlight < 0) {
+        LOG_ERROR("Invalid configuration: Pipeline workers and max_in_flight must not be negative.");
+        return false;
+    }
+
+    if (inferenceInFlight < 1) {
+        LOG_ERROR("Invalid configuration: Pipeline inference_in_flight must be at least 1.");
+        return false;
+    }
+
+    if (qualityEnabled && (qualityTargetFPS <= 0.0 || qualityLatencyBudget < 0.0 || qualityMargin < 0.0 ||
+                           qualityMargin >= 0.5 || qualityWindows <= 0 || qualityMaxDetectionInterval < 1 ||
+                           qualityMinInputScale <= 0.0 || qualityMinInputScale > 1.0 || qualityMaxTileScale < 1.0)) {
+        LOG_ERROR("Invalid configuration: Quality controller needs a positive target_fps and windows, a margin in [0, 0.5), "
+                  "max_detection_interval >= 1, min_input_scale in (0, 1] and max_tile_scale >= 1.");
+        return false;
+    }
+
+    if (reidEnabled && (reidModelPath.empty() || reidGallerySize <= 0 || reidAppearanceWeight < 0.0 ||
+                        reidAppearanceWeight > 1.0 || reidMaxDistance < 0.0 || reidMaxDisplacement < 0.0 ||
+                        reidRefreshInterval < 0)) {
+        LOG_ERROR("Invalid configuration: ReID needs a model_path, a positive gallery_size, appearance_weight in [0, 1] "
+                  "and non-negative max_distance and max_displacement.");
+        return false;
+    }
+
+    if (motionGateEnabled && (motionGateWidth <= 0 || motionGateThreshold < 0.0 || motionGateRefresh < 0)) {
+        LOG_ERROR("Invalid configuration: Motion gate needs a positive width and non-negative threshold and refresh_interval.");
+        return false;
+    }
+
+    if (!outputPath.empty() && (outputEveryNth <= 0 || outputQueueSize <= 0 || outputFourCC.size() != 4)) {
+        LOG_ERROR("Invalid configuration: Output needs a 4 character fourcc and positive every_n and queue_size.");
+        return false;
+    }
+
+    if (reloadEnabled && reloadInterval <= 0) {
+        LOG_ERROR("Invalid configuration: Reload interval_ms must be positive.");
+        return false;
+    }
+
+    if (resultsEnabled && (resultsShmName.size() < 2 || resultsShmName.front() != '/' || resultsSlots < 2 ||
+                           resultsMaxTracks <= 0)) {
+        LOG_ERROR("Invalid configuration: Results needs a shm_name starting with '/', at least 2 slots and positive max_tracks.");
+        return false;
+    }
+
+    if (!validateRuntimeSettings(runtimeNext)) {
+        return false;
+    }
+    publishRuntimeSettings(runtimeNext);
+
+    return true;
+}
+
+bool Config::reloadRuntimeSettings(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open config file: %s", filename.c_str());
+        return false;
+    }
+
+    // Only the runtime keys are read, the rest of the file was applied at startup
+    RuntimeSettings next = runtime();
+    int keys = 0;
+    std::string line;
+    std::string section;
+    try {
+        while (std::getline(file, line)) {
+            line = trim(line);
+            if (line.empty()) continue;
+            if (line.front() == '[' && line.back() == ']') {
+                section = line.substr(1, line.size() - 2);
+                continue;
+            }
+            size_t separator = line.find('=');
+            if (separator == std::string::npos) continue;
+            if (parseRuntimeSetting(section, trim(line.substr(0, separator)), trim(line.substr(separator + 1)), next)) {
+                keys++;
+            }
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("Configuration reload failed: %s", e.what());
+        return false;
+    }
+
+    if (keys == 0) {
+        LOG_WARNING("Configuration reload found no runtime settings, keeping the current settings");
+        return false;
+    }
+    if (!validateRuntimeSettings(next)) {
+        LOG_WARNING("Configuration reload rejected, keeping the current settings");
+        return false;
+    }
+    publishRuntimeSettings(next);
+    LOG_INFO("Configuration reloaded: confidence %.2f, IoU %.2f, detection interval %d",
+             next.confidenceThreshold, next.iouThreshold, next.detectionInterval);
+    return true;
+}
+
+bool Config::parseRuntimeSetting(const std::string& section, const std::string& key, const std::string& value,
+                                 RuntimeSettings& settings) {
+    std::string trimmed = trim(removeComment(value));
+    if (section == "Model" && key == "confidence_threshold") {
+        settings.confidenceThreshold = std::stof(trimmed);
+    } else if (section == "Tracking" && key == "iou_threshold") {
+        settings.iouThreshold = std::stof(trimmed);
+    } else if (section == "Tracking" && key == "max_frames_to_skip") {
+        settings.maxFramesToSkip = std::stoi(trimmed);
+    } else if (section == "Tracking" && key == "detection_interval") {
+        settings.detectionInterval = std::stoi(trimmed);
+    } else if (section == "Tiling" && key == "nms_threshold") {
+        settings.tileNMSThreshold = std::stof(trimmed);
+    } else if (section == "Logging" && key == "debug") {
+        if (parseBool(trimmed)) {
+            settings.logLevelMask |= LOG_LV_DEBUG;
+        } else {
+            settings.logLevelMask &= ~LOG_LV_DEBUG;
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Config::validateRuntimeSettings(const RuntimeSettings& settings) {
+    if (settings.confidenceThreshold < 0.0f || settings.confidenceThreshold > 1.0f ||
+        settings.iouThreshold <= 0.0f || settings.iouThreshold > 1.0f ||
+        settings.tileNMSThreshold <= 0.0f || settings.tileNMSThreshold > 1.0f) {
+        LOG_ERROR("Invalid configuration: confidence_threshold must be in [0, 1], iou_threshold and nms_threshold in (0, 1].");
+        return false;
+    }
+    if (settings.maxFramesToSkip < 0 || settings.detectionInterval < 1) {
+        LOG_ERROR("Invalid configuration: max_frames_to_skip must not be negative and detection_interval must be at least 1.");
+        return false;
+    }
     return true;
+}
+
+void Config::publishRuntimeSettings(const RuntimeSettings& settings) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    publishedSettings.push_back(std::make_unique<const RuntimeSettings>(settings));
+    runtimeSettings.store(publishedSettings.back().get(), std::memory_order_release);
 }
\ No newline at end of file
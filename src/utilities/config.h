@@ -5,7 +5,28 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+#include "logger.h"
+
+/**
+ * @struct RuntimeSettings
+ * @brief Settings that may change while the pipeline runs
+ *
+ * Published as an immutable snapshot; a reload publishes a new one, so a reader
+ * holding a snapshot sees a consistent set of values.
+ */
+struct RuntimeSettings {
+    float confidenceThreshold = 0.5f;   ///< Minimum detection confidence
+    float iouThreshold = 0.5f;          ///< Minimum overlap to continue a track
+    int maxFramesToSkip = 10;           ///< Frames a track may go unmatched
+    float tileNMSThreshold = 0.5f;      ///< IoU merging detections across tile seams
+    int detectionInterval = 1;          ///< Inference runs on every Nth frame at least
+    int logLevelMask = LOG_LV_ERROR | LOG_LV_WARNING | LOG_LV_INFO; ///< Enabled log levels
+};
 
 /**
  * @class Config
@@ -18,8 +39,12 @@ public:
      * @brief Specifies the source of input for the application
      */
     enum class InputSource {
-        VIDEO,  /**< Input from a video file */
-        CAMERA  /**< Input from a camera */
+        VIDEO,      /**< Input from a video file */
+        CAMERA,     /**< Input from a camera */
+        SYNTHETIC,      /**< Procedurally rendered scene with ground truth */
+        IMAGE_SEQUENCE, /**< Directory of still images */
+        RAW,            /**< Memory-mapped Y4M or headerless raw video */
+        SHM             /**< Shared-memory ring filled by another process */
     };
 
     /**
@@ -29,6 +54,30 @@ public:
      */
     static bool loadFromFile(const std::string& filename);
 
+    /**
+     * @brief Re-reads the runtime settings from a file and publishes them
+     *
+     * All other settings keep the values they were loaded with, as do runtime keys
+     * missing from the file. Invalid values, or a file without any runtime key such
+     * as one an editor has truncated but not yet rewritten, leave the current
+     * snapshot in place.
+     * @param filename The path to the configuration file
+     * @return true if a new snapshot was published
+     */
+    static bool reloadRuntimeSettings(const std::string& filename);
+
+    /**
+     * @brief Gets the current runtime settings without locking
+     * @return The latest published snapshot; it stays valid for the lifetime of the process
+     */
+    static const RuntimeSettings& runtime() { return *runtimeSettings.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Publishes a runtime settings snapshot, for example to restore an earlier one
+     * @param settings The new runtime settings
+     */
+    static void setRuntimeSettings(const RuntimeSettings& settings) { publishRuntimeSettings(settings); }
+
     /**
      * @brief Sets the input source
      * @param source The input source to set
@@ -61,6 +110,66 @@ public:
         return videoPath;
     }
 
+    /**
+     * @brief Gets the directory of the image sequence
+     * @return The directory containing the frames
+     */
+    static std::string getImageDirectory() { return imageDirectory; }
+
+    /**
+     * @brief Gets the number of threads decoding image sequences
+     * @return The number of decode threads
+     */
+    static int getDecodeThreads() { return decodeThreads; }
+
+    /**
+     * @brief Gets the path to the raw video file
+     * @return The path to the raw video file
+     */
+    static std::string getRawPath() { return rawPath; }
+
+    /**
+     * @brief Gets the layout of the raw video file
+     * @return "y4m", "bgr" or "nv12"
+     */
+    static std::string getRawFormat() { return rawFormat; }
+
+    /**
+     * @brief Gets the frame width of a headerless raw video
+     * @return The frame width in pixels
+     */
+    static int getRawWidth() { return rawWidth; }
+
+    /**
+     * @brief Gets the frame height of a headerless raw video
+     * @return The frame height in pixels
+     */
+    static int getRawHeight() { return rawHeight; }
+
+    /**
+     * @brief Gets the frame rate of a headerless raw video
+     * @return The frame rate in frames per second
+     */
+    static double getRawFPS() { return rawFPS; }
+
+    /**
+     * @brief Gets the name of the shared-memory frame ring
+     * @return POSIX shared-memory object name, starting with '/'
+     */
+    static std::string getShmName() { return shmName; }
+
+    /**
+     * @brief Gets how long the shared-memory source waits for the producer
+     * @return Timeout in milliseconds, at startup and for each frame
+     */
+    static int getShmTimeout() { return shmTimeout; }
+
+    /**
+     * @brief Checks whether the pipeline runs in low-latency mode
+     * @return true if only the newest frame is processed at every stage
+     */
+    static bool getLowLatency() { return lowLatency; }
+
     /**
      * @brief Gets the path to the model file
      * @return The path to the model file
@@ -71,32 +180,486 @@ public:
      * @brief Gets the confidence threshold
      * @return The confidence threshold
      */
-    static float getConfidenceThreshold() { return confidenceThreshold; }
+    static float getConfidenceThreshold() { return runtime().confidenceThreshold; }
+
+    /**
+     * @brief Gets the model input width
+     * @return Width in pixels images are resized to for inference
+     */
+    static int getInputWidth() { return inputWidth; }
+
+    /**
+     * @brief Gets the model input height
+     * @return Height in pixels images are resized to for inference
+     */
+    static int getInputHeight() { return inputHeight; }
+
+    /**
+     * @brief Checks whether images are letterboxed into the model input
+     * @return true if images keep their aspect ratio and are padded, false if they are stretched
+     */
+    static bool getLetterbox() { return letterbox; }
+
+    /**
+     * @brief Gets the number of warm-up inferences run before the pipeline starts
+     * @return Warm-up run count, 0 to start cold
+     */
+    static int getWarmupRuns() { return warmupRuns; }
 
     /**
      * @brief Gets the IoU threshold
      * @return The IoU threshold
      */
-    static float getIoUThreshold() { return iouThreshold; }
+    static float getIoUThreshold() { return runtime().iouThreshold; }
 
     /**
      * @brief Gets the maximum number of frames to skip
      * @return The maximum number of frames to skip
      */
-    static int getMaxFramesToSkip() { return maxFramesToSkip; }
+    static int getMaxFramesToSkip() { return runtime().maxFramesToSkip; }
+
+    /**
+     * @brief Gets the minimum number of frames per inference
+     * @return Detection interval, 1 to infer every frame
+     */
+    static int getDetectionInterval() { return runtime().detectionInterval; }
+
+    /**
+     * @brief Gets the number of past states kept per track
+     * @return Trajectory length in observations
+     */
+    static int getTrajectoryLength() { return trajectoryLength; }
+
+    /**
+     * @brief Checks whether frames are cut into tiles for inference
+     * @return true if tiled inference is enabled
+     */
+    static bool getTilingEnabled() { return tilingEnabled; }
+
+    /**
+     * @brief Gets the side length of an inference tile
+     * @return The tile size in pixels
+     */
+    static int getTileSize() { return tileSize; }
+
+    /**
+     * @brief Gets the minimum overlap between neighbouring tiles
+     * @return The overlap as a fraction of the tile size
+     */
+    static double getTileOverlap() { return tileOverlap; }
+
+    /**
+     * @brief Checks whether the whole frame is inferred in addition to the tiles
+     * @return true if a downscaled full-frame pass is added to the tile batch
+     */
+    static bool getTileFullFrame() { return tileFullFrame; }
+
+    /**
+     * @brief Gets the IoU threshold merging detections across tile seams
+     * @return The non-maximum suppression IoU threshold
+     */
+    static float getTileNMSThreshold() { return runtime().tileNMSThreshold; }
+
+    /**
+     * @brief Gets the maximum number of images per inference call
+     * @return The maximum batch size, 0 for no limit
+     */
+    static int getTileMaxBatch() { return tileMaxBatch; }
+
+    /**
+     * @brief Checks whether inference is skipped on frames without change
+     * @return true if the motion gate is enabled
+     */
+    static bool getMotionGateEnabled() { return motionGateEnabled; }
+
+    /**
+     * @brief Gets the width of the image the motion gate compares
+     * @return The comparison width in pixels
+     */
+    static int getMotionGateWidth() { return motionGateWidth; }
+
+    /**
+     * @brief Gets the change threshold of the motion gate
+     * @return Mean absolute difference per pixel of a 16x16 block that counts as change
+     */
+    static double getMotionGateThreshold() { return motionGateThreshold; }
+
+    /**
+     * @brief Gets the forced refresh interval of the motion gate
+     * @return Maximum number of frames between inferences, 0 for no limit
+     */
+    static int getMotionGateRefresh() { return motionGateRefresh; }
+
+    /**
+     * @brief Checks whether frames between full scans are only inferred around existing tracks
+     * @return true if track-guided ROI inference is enabled
+     */
+    static bool getROIEnabled() { return roiEnabled; }
+
+    /**
+     * @brief Gets the full-frame scan interval of ROI inference
+     * @return Scan the whole frame every N frames
+     */
+    static int getROIFullScanInterval() { return roiFullScanInterval; }
+
+    /**
+     * @brief Gets the padding added around each track for ROI inference
+     * @return Padding on every side as a fraction of the larger box side
+     */
+    static double getROIPadding() { return roiPadding; }
+
+    /**
+     * @brief Gets the minimum side length of an ROI crop
+     * @return The minimum crop size in pixels
+     */
+    static int getROIMinSize() { return roiMinSize; }
+
+    /**
+     * @brief Checks whether the pipeline stages run as tasks on a work-stealing pool
+     * @return true for the task scheduler, false for one thread per stage
+     */
+    static bool getTaskScheduler() { return taskScheduler; }
+
+    /**
+     * @brief Gets the number of task scheduler workers
+     * @return Worker threads, 0 for one per hardware thread
+     */
+    static int getSchedulerWorkers() { return schedulerWorkers; }
+
+    /**
+     * @brief Gets the maximum number of frames in flight under the task scheduler
+     * @return Frame limit, 0 for twice the worker count
+     */
+    static int getSchedulerMaxInFlight() { return schedulerMaxInFlight; }
+
+    /**
+     * @brief Gets the number of frames the tracker thread keeps in inference at once
+     * @return Frame limit, 1 for synchronous inference
+     */
+    static int getInferenceInFlight() { return inferenceInFlight; }
+
+    /**
+     * @brief Checks whether the quality controller adapts the pipeline at runtime
+     * @return true if the quality controller is enabled
+     */
+    static bool getQualityEnabled() { return qualityEnabled; }
+
+    /**
+     * @brief Gets the frame rate the quality controller holds
+     * @return Target frames per second
+     */
+    static double getQualityTargetFPS() { return qualityTargetFPS; }
+
+    /**
+     * @brief Gets the latency budget of the quality controller
+     * @return Glass-to-glass latency in milliseconds, 0 if only the frame rate is controlled
+     */
+    static double getQualityLatencyBudget() { return qualityLatencyBudget; }
+
+    /**
+     * @brief Gets the relative dead band around the quality controller targets
+     * @return Margin as a fraction of the target
+     */
+    static double getQualityMargin() { return qualityMargin; }
+
+    /**
+     * @brief Gets the number of one-second windows over budget before the quality is lowered
+     * @return Number of windows
+     */
+    static int getQualityWindows() { return qualityWindows; }
+
+    /**
+     * @brief Gets the largest detection interval the quality controller may use
+     * @return Maximum number of frames per inference
+     */
+    static int getQualityMaxDetectionInterval() { return qualityMaxDetectionInterval; }
+
+    /**
+     * @brief Gets the smallest model input resolution the quality controller may use
+     * @return Scale relative to the configured input size
+     */
+    static double getQualityMinInputScale() { return qualityMinInputScale; }
+
+    /**
+     * @brief Gets the largest tile size the quality controller may use
+     * @return Scale relative to the configured tile size
+     */
+    static double getQualityMaxTileScale() { return qualityMaxTileScale; }
+
+    /**
+     * @brief Checks whether appearance re-identification assists track association
+     * @return true if re-identification is enabled
+     */
+    static bool getReIDEnabled() { return reidEnabled; }
+
+    /**
+     * @brief Gets the path to the re-identification model
+     * @return The ONNX model path
+     */
+    static std::string getReIDModelPath() { return reidModelPath; }
+
+    /**
+     * @brief Gets the number of embeddings kept per track
+     * @return Gallery size
+     */
+    static int getReIDGallerySize() { return reidGallerySize; }
+
+    /**
+     * @brief Gets the weight of the appearance distance in the association cost
+     * @return Weight in [0, 1]; the IoU distance gets the rest
+     */
+    static double getReIDAppearanceWeight() { return reidAppearanceWeight; }
+
+    /**
+     * @brief Gets the largest cosine distance at which a detection may take over a track
+     * @return Cosine distance in [0, 2]
+     */
+    static double getReIDMaxDistance() { return reidMaxDistance; }
+
+    /**
+     * @brief Gets how far a lost track may be re-acquired by appearance alone
+     * @return Distance from the track's predicted box center, in box sizes per frame the track was lost
+     */
+    static double getReIDMaxDisplacement() { return reidMaxDisplacement; }
+
+    /**
+     * @brief Gets how often a confidently matched track gets a fresh embedding
+     * @return Interval in frames, 0 to embed ambiguous detections only
+     */
+    static int getReIDRefreshInterval() { return reidRefreshInterval; }
+
+    /**
+     * @brief Gets the synthetic frame width
+     * @return The synthetic frame width in pixels
+     */
+    static int getSyntheticWidth() { return syntheticWidth; }
+
+    /**
+     * @brief Gets the synthetic frame height
+     * @return The synthetic frame height in pixels
+     */
+    static int getSyntheticHeight() { return syntheticHeight; }
+
+    /**
+     * @brief Gets the synthetic frame rate
+     * @return The synthetic frame rate in frames per second
+     */
+    static double getSyntheticFPS() { return syntheticFPS; }
+
+    /**
+     * @brief Gets the number of objects in the synthetic scene
+     * @return The number of objects
+     */
+    static int getSyntheticObjects() { return syntheticObjects; }
+
+    /**
+     * @brief Gets the length of the synthetic stream
+     * @return The number of frames, 0 for an endless stream
+     */
+    static int getSyntheticFrames() { return syntheticFrames; }
+
+    /**
+     * @brief Gets the seed of the synthetic scene generator
+     * @return The seed
+     */
+    static unsigned int getSyntheticSeed() { return syntheticSeed; }
+
+    /**
+     * @brief Checks whether synthetic ground truth replaces model inference
+     * @return true if ground truth boxes are injected as detections
+     */
+    static bool getInjectGroundTruth() { return injectGroundTruth; }
+
+    /**
+     * @brief Gets the directory of the detection cache
+     * @return The cache directory, empty when caching is disabled
+     */
+    static std::string getDetectionCacheDir() { return detectionCacheDir; }
+
+    /**
+     * @brief Gets the path of the annotated output video
+     * @return The output video path, empty when recording is disabled
+     */
+    static std::string getOutputPath() { return outputPath; }
+
+    /**
+     * @brief Gets the path of the binary track log
+     * @return The track log path, empty when track logging is disabled
+     */
+    static std::string getTrackLogPath() { return trackLogPath; }
+
+    /**
+     * @brief Gets the codec of the annotated output video
+     * @return Four character codec code
+     */
+    static std::string getOutputFourCC() { return outputFourCC; }
+
+    /**
+     * @brief Gets the frame rate of the annotated output video
+     * @return Frames per second, 0 to use the input frame rate
+     */
+    static double getOutputFPS() { return outputFPS; }
+
+    /**
+     * @brief Gets the recording interval
+     * @return Write one of every N frames
+     */
+    static int getOutputEveryNth() { return outputEveryNth; }
+
+    /**
+     * @brief Checks whether only frames with detections are recorded
+     * @return true if frames without detections are skipped
+     */
+    static bool getOutputOnlyDetections() { return outputOnlyDetections; }
+
+    /**
+     * @brief Gets the number of frames that may wait for the encoder
+     * @return The recorder queue size
+     */
+    static int getOutputQueueSize() { return outputQueueSize; }
+
+    /**
+     * @brief Checks what happens when the encoder falls behind
+     * @return true to drop frames, false to wait for the encoder
+     */
+    static bool getOutputDropWhenFull() { return outputDropWhenFull; }
 
     /**
      * @brief Gets the log level mask
      * @return The log level mask
      */
-    static int getLogLevelMask() { return logLevelMask; }
+    static int getLogLevelMask() { return runtime().logLevelMask; }
+
+    /**
+     * @brief Checks whether the configuration file is watched for runtime changes
+     * @return true if the runtime settings are reloaded when the file changes
+     */
+    static bool getReloadEnabled() { return reloadEnabled; }
+
+    /**
+     * @brief Gets how often the configuration file is checked for changes
+     * @return Interval in milliseconds
+     */
+    static int getReloadInterval() { return reloadInterval; }
+
+    /**
+     * @brief Checks whether tracking results are published to shared memory
+     * @return true if the results publisher is enabled
+     */
+    static bool getResultsEnabled() { return resultsEnabled; }
+
+    /**
+     * @brief Gets the name of the shared-memory results ring
+     * @return POSIX shared-memory object name, starting with '/'
+     */
+    static std::string getResultsShmName() { return resultsShmName; }
+
+    /**
+     * @brief Gets the number of frames the results ring keeps
+     * @return Slot count
+     */
+    static int getResultsSlots() { return resultsSlots; }
+
+    /**
+     * @brief Gets the most tracks published per frame
+     * @return Track capacity of a slot
+     */
+    static int getResultsMaxTracks() { return resultsMaxTracks; }
 
 private:
     static inline InputSource inputSource = InputSource::VIDEO;
     static inline std::string videoPath = "";
+    static inline std::string imageDirectory = "";
+    static inline int decodeThreads = 4;
+    static inline std::string rawPath = "";
+    static inline std::string rawFormat = "y4m";
+    static inline int rawWidth = 0;
+    static inline int rawHeight = 0;
+    static inline double rawFPS = 30.0;
+    static inline std::string shmName = "/object-tracking";
+    static inline int shmTimeout = 5000;
+    static inline bool lowLatency = false;
     static inline std::string modelPath = "";
-    static inline float confidenceThreshold = 0.5f;
-    static inline float iouThreshold = 0.5f;
-    static inline int maxFramesToSkip = 10;
-    static inline int logLevelMask = 0;
+    static inline int inputWidth = 640;
+    static inline int inputHeight = 640;
+    static inline bool letterbox = false;
+    static inline int warmupRuns = 2;
+    static inline int trajectoryLength = 64;
+    static inline bool tilingEnabled = false;
+    static inline int tileSize = 640;
+    static inline double tileOverlap = 0.2;
+    static inline bool tileFullFrame = true;
+    static inline int tileMaxBatch = 0;
+    static inline bool roiEnabled = false;
+    static inline int roiFullScanInterval = 10;
+    static inline double roiPadding = 0.5;
+    static inline int roiMinSize = 160;
+    static inline bool taskScheduler = false;
+    static inline int schedulerWorkers = 0;
+    static inline int schedulerMaxInFlight = 0;
+    static inline int inferenceInFlight = 2;
+    static inline bool qualityEnabled = false;
+    static inline double qualityTargetFPS = 15.0;
+    static inline double qualityLatencyBudget = 0.0;
+    static inline double qualityMargin = 0.1;
+    static inline int qualityWindows = 3;
+    static inline int qualityMaxDetectionInterval = 3;
+    static inline double qualityMinInputScale = 0.5;
+    static inline double qualityMaxTileScale = 2.0;
+    static inline bool reidEnabled = false;
+    static inline std::string reidModelPath = "";
+    static inline int reidGallerySize = 10;
+    static inline double reidAppearanceWeight = 0.5;
+    static inline double reidMaxDistance = 0.3;
+    static inline double reidMaxDisplacement = 1.0;
+    static inline int reidRefreshInterval = 15;
+    static inline bool motionGateEnabled = false;
+    static inline int motionGateWidth = 160;
+    static inline double motionGateThreshold = 6.0;
+    static inline int motionGateRefresh = 30;
+    static inline bool reloadEnabled = false;
+    static inline int reloadInterval = 1000;
+    static inline bool resultsEnabled = false;
+    static inline std::string resultsShmName = "/object-tracking-results";
+    static inline int resultsSlots = 8;
+    static inline int resultsMaxTracks = 256;
+
+    /**
+     * @brief Parse a runtime setting into a snapshot
+     * @return true if the key is a runtime setting
+     */
+    static bool parseRuntimeSetting(const std::string& section, const std::string& key, const std::string& value,
+                                    RuntimeSettings& settings);
+
+    /**
+     * @brief Check a snapshot for invalid values, logging the first problem
+     */
+    static bool validateRuntimeSettings(const RuntimeSettings& settings);
+
+    /**
+     * @brief Make a snapshot the current runtime settings
+     */
+    static void publishRuntimeSettings(const RuntimeSettings& settings);
+
+    static inline const RuntimeSettings defaultRuntimeSettings{};
+    static inline std::atomic<const RuntimeSettings*> runtimeSettings{&defaultRuntimeSettings};
+    static inline std::mutex publishMutex;  ///< Serializes publishers
+    // Readers hold plain pointers, so published snapshots live until exit; there is one per reload
+    static inline std::vector<std::unique_ptr<const RuntimeSettings>> publishedSettings;
+    static inline int syntheticWidth = 1280;
+    static inline int syntheticHeight = 720;
+    static inline double syntheticFPS = 30.0;
+    static inline int syntheticObjects = 8;
+    static inline int syntheticFrames = 300;
+    static inline unsigned int syntheticSeed = 42;
+    static inline bool injectGroundTruth = false;
+    static inline std::string detectionCacheDir = "";
+    static inline std::string outputPath = "";
+    static inline std::string trackLogPath = "";
+    static inline std::string outputFourCC = "mp4v";
+    static inline double outputFPS = 0.0;
+    static inline int outputEveryNth = 1;
+    static inline bool outputOnlyDetections = false;
+    static inline int outputQueueSize = 8;
+    static inline bool outputDropWhenFull = true;
 };
\ No newline at end of file
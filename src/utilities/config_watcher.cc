@@ -0,0 +1,70 @@
+#include "config_watcher.h"
+#include "config.h"
+#include "logger.h"
+
+ConfigWatcher::ConfigWatcher(const std::string& path, std::chrono::milliseconds interval)
+    : path(path), interval(interval) {
+    // The file as loaded at startup is the baseline
+    std::error_code error;
+    lastWrite = std::filesystem::last_write_time(path, error);
+    lastSize = std::filesystem::file_size(path, error);
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+void ConfigWatcher::start() {
+    if (thread.joinable()) return;
+    thread = std::thread(&ConfigWatcher::run, this);
+    LOG_INFO("Watching %s for runtime setting changes", path.c_str());
+}
+
+void ConfigWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool ConfigWatcher::poll() {
+    std::error_code error;
+    auto write = std::filesystem::last_write_time(path, error);
+    if (error) return false;  // Editors may replace the file; try again on the next check
+    std::uintmax_t size = std::filesystem::file_size(path, error);
+    if (error) return false;
+    if (write == lastWrite && size == lastSize) {
+        changed = false;
+        return false;
+    }
+
+    // An editor may still be writing; wait until a check sees the same version again
+    if (!changed || write != changedWrite || size != changedSize) {
+        changed = true;
+        changedWrite = write;
+        changedSize = size;
+        return false;
+    }
+
+    changed = false;
+    lastWrite = write;
+    lastSize = size;
+    if (!Config::reloadRuntimeSettings(path)) {
+        return false;
+    }
+    Logger::getInstance().setLogLevel(Config::getLogLevelMask());
+    return true;
+}
+
+void ConfigWatcher::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, interval, [this] { return stopping; })) {
+        lock.unlock();
+        poll();
+        lock.lock();
+    }
+}
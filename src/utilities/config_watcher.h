@@ -0,0 +1,76 @@
+/**
+ * @file config_watcher.h
+ * @brief Defines the ConfigWatcher class, which reloads the runtime settings when the configuration file changes
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @class ConfigWatcher
+ * @brief Background thread polling the configuration file for changes
+ *
+ * When the file's modification time or size changes and then stays the same for
+ * one more check, the runtime settings are re-read and published through
+ * Config::reloadRuntimeSettings(), and the log level is applied. Waiting for the
+ * file to settle keeps a save in progress from being read. Readers pick up the
+ * new values on their next access.
+ */
+class ConfigWatcher {
+public:
+    /**
+     * @brief Constructor for the ConfigWatcher class
+     * @param path Configuration file to watch
+     * @param interval Time between checks
+     */
+    ConfigWatcher(const std::string& path, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Destructor, stops the thread
+     */
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    /**
+     * @brief Start polling in the background
+     */
+    void start();
+
+    /**
+     * @brief Stop the background thread
+     */
+    void stop();
+
+    /**
+     * @brief Check the file once and reload it if it changed and has settled since the last check
+     * @return true if new settings were published
+     */
+    bool poll();
+
+private:
+    /**
+     * @brief Polling loop run by the background thread
+     */
+    void run();
+
+    std::string path;                                   ///< Watched file
+    std::chrono::milliseconds interval;                 ///< Time between checks
+    std::filesystem::file_time_type lastWrite;          ///< Modification time of the last applied version
+    std::uintmax_t lastSize = 0;                        ///< File size of the last applied version
+    std::filesystem::file_time_type changedWrite;       ///< Modification time of a change waiting to settle
+    std::uintmax_t changedSize = 0;                     ///< File size of a change waiting to settle
+    bool changed = false;                               ///< A change was seen and is waiting to settle
+    std::thread thread;                                 ///< Polling thread
+    std::mutex mutex;                                   ///< Guards stopping
+    std::condition_variable wake;                       ///< Signalled by stop()
+    bool stopping = false;                              ///< stop() was called
+};
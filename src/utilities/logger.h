@@ -6,6 +6,7 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -61,7 +62,17 @@ public:
      * @param level The log level to set
      */
     void setLogLevel(int level) {
-        currentLogLevel = level;
+        currentLogLevel.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Set the stream log messages are written to
+     *
+     * Call before other threads start logging, e.g. to keep stdout free for machine-readable output.
+     * @param stream Destination of all following messages; must outlive the logger's use of it
+     */
+    void setOutput(std::ostream& stream) {
+        output.store(&stream, std::memory_order_relaxed);
     }
 
     /**
@@ -71,7 +82,7 @@ public:
      * @param ... Additional arguments for formatting
      */
     void logMessage(const char* format, LogLevel level, ...) {
-        if (static_cast<int>(level) & currentLogLevel) {
+        if (static_cast<int>(level) & currentLogLevel.load(std::memory_order_relaxed)) {
             va_list args;
             va_start(args, level);
 
@@ -80,13 +91,14 @@ public:
 
             va_end(args);
 
-            std::cout << getLevelString(level) << ": " << buffer << std::endl;
+            *output.load(std::memory_order_relaxed) << getLevelString(level) << ": " << buffer << std::endl;
         }
     }
 
 private:
-    Logger() : currentLogLevel(LOG_LEVEL) {}
-    int currentLogLevel;
+    Logger() : currentLogLevel(LOG_LEVEL), output(&std::cout) {}
+    std::atomic<int> currentLogLevel;  ///< Changed by configuration reloads while other threads log
+    std::atomic<std::ostream*> output; ///< Stream messages are written to, stdout by default
 
     /**
      * @brief Get the string representation of a log level
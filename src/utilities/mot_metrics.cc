@@ -0,0 +1,145 @@
+#include "mot_metrics.h"
+#include "assignment.h"
+#include <algorithm>
+
+MOTEvaluator::MOTEvaluator(double iouThreshold)
+    : iouThreshold(iouThreshold), iouSum(0.0) {
+}
+
+double MOTEvaluator::iou(const cv::Rect& a, const cv::Rect& b) {
+    int x1 = std::max(a.x, b.x);
+    int y1 = std::max(a.y, b.y);
+    int x2 = std::min(a.x + a.width, b.x + b.width);
+    int y2 = std::min(a.y + a.height, b.y + b.height);
+
+    if (x2 <= x1 || y2 <= y1) return 0.0;
+
+    double intersection = static_cast<double>(x2 - x1) * (y2 - y1);
+    return intersection / (static_cast<double>(a.area()) + b.area() - intersection);
+}
+
+void MOTEvaluator::addFrame(const std::vector<cv::Rect>& gtBoxes, const std::vector<int>& gtIDs,
+                            const std::vector<cv::Rect>& boxes, const std::vector<int>& trackIDs) {
+    size_t numGT = gtBoxes.size();
+    size_t numHyp = boxes.size();
+
+    std::vector<std::vector<double>> ious(numGT, std::vector<double>(numHyp, 0.0));
+    for (size_t g = 0; g < numGT; ++g) {
+        gtCounts[gtIDs[g]]++;
+        for (size_t h = 0; h < numHyp; ++h) {
+            ious[g][h] = iou(gtBoxes[g], boxes[h]);
+            if (ious[g][h] >= iouThreshold) {
+                overlaps[{gtIDs[g], trackIDs[h]}]++;
+            }
+        }
+    }
+    for (size_t h = 0; h < numHyp; ++h) {
+        trackCounts[trackIDs[h]]++;
+    }
+
+    std::vector<int> gtMatch(numGT, -1);
+    std::vector<bool> hypUsed(numHyp, false);
+
+    // Keep last frame's correspondences that are still valid
+    for (size_t g = 0; g < numGT; ++g) {
+        auto previous = lastMatch.find(gtIDs[g]);
+        if (previous == lastMatch.end()) continue;
+        for (size_t h = 0; h < numHyp; ++h) {
+            if (!hypUsed[h] && trackIDs[h] == previous->second && ious[g][h] >= iouThreshold) {
+                gtMatch[g] = static_cast<int>(h);
+                hypUsed[h] = true;
+                break;
+            }
+        }
+    }
+
+    // Resolve the remaining boxes with a minimum-cost assignment on 1 - IoU
+    std::vector<size_t> openGT, openHyp;
+    for (size_t g = 0; g < numGT; ++g) if (gtMatch[g] < 0) openGT.push_back(g);
+    for (size_t h = 0; h < numHyp; ++h) if (!hypUsed[h]) openHyp.push_back(h);
+
+    std::vector<std::vector<double>> cost(openGT.size(), std::vector<double>(openHyp.size()));
+    for (size_t i = 0; i < openGT.size(); ++i) {
+        for (size_t j = 0; j < openHyp.size(); ++j) {
+            double value = ious[openGT[i]][openHyp[j]];
+            cost[i][j] = value >= iouThreshold ? 1.0 - value : ASSIGNMENT_INFEASIBLE;
+        }
+    }
+
+    std::vector<int> assignment = solveAssignment(cost);
+    for (size_t i = 0; i < openGT.size(); ++i) {
+        if (assignment[i] < 0) continue;
+        size_t g = openGT[i];
+        size_t h = openHyp[assignment[i]];
+        gtMatch[g] = static_cast<int>(h);
+
+        auto previous = lastMatch.find(gtIDs[g]);
+        if (previous != lastMatch.end() && previous->second != trackIDs[h]) {
+            totals.idSwitches++;
+        }
+    }
+
+    int matches = 0;
+    for (size_t g = 0; g < numGT; ++g) {
+        if (gtMatch[g] < 0) continue;
+        matches++;
+        iouSum += ious[g][gtMatch[g]];
+        lastMatch[gtIDs[g]] = trackIDs[gtMatch[g]];
+    }
+
+    totals.frames++;
+    totals.groundTruth += static_cast<int>(numGT);
+    totals.hypotheses += static_cast<int>(numHyp);
+    totals.truePositives += matches;
+    totals.falseNegatives += static_cast<int>(numGT) - matches;
+    totals.falsePositives += static_cast<int>(numHyp) - matches;
+}
+
+MOTMetrics MOTEvaluator::compute() const {
+    MOTMetrics metrics = totals;
+
+    if (metrics.groundTruth > 0) {
+        metrics.mota = 1.0 - static_cast<double>(metrics.falseNegatives + metrics.falsePositives +
+                                                 metrics.idSwitches) / metrics.groundTruth;
+    }
+    if (metrics.truePositives > 0) {
+        metrics.motp = iouSum / metrics.truePositives;
+    }
+
+    // Global identity assignment maximizing the number of co-occurring frames
+    std::vector<int> gtIndex, trackIndex;
+    std::map<int, size_t> gtRow, trackColumn;
+    for (const auto& entry : gtCounts) {
+        gtRow[entry.first] = gtIndex.size();
+        gtIndex.push_back(entry.first);
+    }
+    for (const auto& entry : trackCounts) {
+        trackColumn[entry.first] = trackIndex.size();
+        trackIndex.push_back(entry.first);
+    }
+
+    std::vector<std::vector<double>> cost(gtIndex.size(), std::vector<double>(trackIndex.size(), 0.0));
+    for (const auto& entry : overlaps) {
+        cost[gtRow[entry.first.first]][trackColumn[entry.first.second]] = -entry.second;
+    }
+
+    int idTruePositives = 0;
+    std::vector<int> assignment = solveAssignment(cost);
+    for (size_t g = 0; g < assignment.size(); ++g) {
+        if (assignment[g] >= 0) {
+            idTruePositives += static_cast<int>(-cost[g][assignment[g]]);
+        }
+    }
+
+    if (metrics.groundTruth + metrics.hypotheses > 0) {
+        metrics.idf1 = 2.0 * idTruePositives / (metrics.groundTruth + metrics.hypotheses);
+    }
+    if (metrics.hypotheses > 0) {
+        metrics.idPrecision = static_cast<double>(idTruePositives) / metrics.hypotheses;
+    }
+    if (metrics.groundTruth > 0) {
+        metrics.idRecall = static_cast<double>(idTruePositives) / metrics.groundTruth;
+    }
+
+    return metrics;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file mot_metrics.h
+ * @brief CLEAR MOT and identity metrics for multi-object tracking evaluation
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct MOTMetrics
+ * @brief Summary of a tracking evaluation
+ */
+struct MOTMetrics {
+    int frames = 0;          /**< Number of evaluated frames */
+    int groundTruth = 0;     /**< Number of ground truth boxes */
+    int hypotheses = 0;      /**< Number of tracker boxes */
+    int truePositives = 0;   /**< Matched boxes */
+    int falsePositives = 0;  /**< Unmatched tracker boxes */
+    int falseNegatives = 0;  /**< Unmatched ground truth boxes */
+    int idSwitches = 0;      /**< Ground truth objects matched to a different track than before */
+    double mota = 0.0;       /**< Multiple object tracking accuracy */
+    double motp = 0.0;       /**< Mean IoU of matched boxes */
+    double idf1 = 0.0;       /**< Identity F1 score */
+    double idPrecision = 0.0;/**< Identity precision */
+    double idRecall = 0.0;   /**< Identity recall */
+};
+
+/**
+ * @class MOTEvaluator
+ * @brief Accumulates per-frame matches between ground truth and tracker output
+ *
+ * Frame matching follows the CLEAR MOT procedure: correspondences from the
+ * previous frame are kept while their IoU stays above the threshold, the rest
+ * are resolved with a minimum-cost assignment. IDF1 is computed from a global
+ * one-to-one assignment between ground truth and tracker identities.
+ */
+class MOTEvaluator {
+public:
+    /**
+     * @brief Constructor for the MOTEvaluator class
+     * @param iouThreshold Minimum IoU for a tracker box to match a ground truth box
+     */
+    explicit MOTEvaluator(double iouThreshold = 0.5);
+
+    /**
+     * @brief Add the ground truth and tracker output of one frame
+     * @param gtBoxes Ground truth boxes
+     * @param gtIDs Ground truth IDs matching gtBoxes
+     * @param boxes Tracker boxes
+     * @param trackIDs Track IDs matching boxes
+     */
+    void addFrame(const std::vector<cv::Rect>& gtBoxes, const std::vector<int>& gtIDs,
+                  const std::vector<cv::Rect>& boxes, const std::vector<int>& trackIDs);
+
+    /**
+     * @brief Compute the metrics over all frames added so far
+     * @return The evaluation summary
+     */
+    MOTMetrics compute() const;
+
+    /**
+     * @brief Calculate the Intersection over Union (IoU) between two boxes
+     */
+    static double iou(const cv::Rect& a, const cv::Rect& b);
+
+private:
+    double iouThreshold;                         ///< Match threshold
+    MOTMetrics totals;                           ///< Running CLEAR MOT counts
+    double iouSum;                               ///< Sum of IoU over matches, for MOTP
+    std::map<int, int> lastMatch;                ///< Ground truth ID -> last matched track ID
+    std::map<std::pair<int, int>, int> overlaps; ///< (GT ID, track ID) -> frames above threshold
+    std::map<int, int> gtCounts;                 ///< Ground truth ID -> number of boxes
+    std::map<int, int> trackCounts;              ///< Track ID -> number of boxes
+};
@@ -7,10 +7,30 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
+#include <vector>
+
+/**
+ * @enum QueueOverflowPolicy
+ * @brief What push() does when a bounded queue is full
+ */
+enum class QueueOverflowPolicy {
+    BLOCK,        /**< Wait until a consumer makes space */
+    DROP_OLDEST   /**< Discard the oldest queued items; with capacity 1 the queue is a latest-value mailbox */
+};
 
 /**
  * @class ThreadSafeQueue
  * @brief A thread-safe implementation of a queue
+ *
+ * The queue is unbounded by default. With a capacity, push() either blocks while
+ * the queue is full or discards the oldest items, depending on the overflow
+ * policy, and try_push() fails instead of blocking.
+ *
+ * close() ends the queue: waiting producers and consumers wake up, further
+ * pushes are rejected, and pops return false once the remaining items are gone.
+ * The bulk operations take the lock once for many items.
+ *
  * @tparam T The type of elements stored in the queue
  */
 template<typename T>
@@ -19,28 +39,210 @@ private:
     std::queue<T> queue;
     std::mutex mutex;
     std::condition_variable cond;
+    std::condition_variable notFull;
+    size_t capacity;
+    QueueOverflowPolicy policy;
+    size_t droppedItems = 0;
+    bool closed = false;
+
+    /**
+     * @brief Make space for one item according to the overflow policy; the lock must be held
+     * @param lock Lock on mutex
+     * @param discarded Receives dropped items, so they are destroyed after the lock is released
+     * @return false if the queue was closed while waiting
+     */
+    bool makeSpace(std::unique_lock<std::mutex>& lock, std::vector<T>& discarded) {
+        if (policy == QueueOverflowPolicy::DROP_OLDEST) {
+            while (capacity != 0 && queue.size() >= capacity) {
+                discarded.push_back(std::move(queue.front()));
+                queue.pop();
+                droppedItems++;
+            }
+        } else if (capacity != 0 && queue.size() >= capacity) {
+            // Consumers may not have been woken for items pushed earlier under this lock
+            cond.notify_all();
+            notFull.wait(lock, [this] { return closed || queue.size() < capacity; });
+        }
+        return !closed;
+    }
+
+    /**
+     * @brief Move the front item out; the lock must be held and the queue not empty
+     */
+    void takeFront(T& item) {
+        item = std::move(queue.front());
+        queue.pop();
+        notFull.notify_one();
+    }
 
 public:
     /**
-     * @brief Push an item onto the queue
+     * @brief Constructor for the ThreadSafeQueue class
+     * @param capacity Maximum number of queued items, 0 for unbounded
+     * @param policy What push() does when the queue is full
+     */
+    explicit ThreadSafeQueue(size_t capacity = 0, QueueOverflowPolicy policy = QueueOverflowPolicy::BLOCK)
+        : capacity(capacity), policy(policy) {}
+
+    /**
+     * @brief Push an item onto the queue, waiting for space or discarding the oldest item if the queue is full
      * @param item The item to be pushed
+     * @return false if the queue is closed and the item was discarded
      */
-    void push(T item) {
+    bool push(T item) {
+        std::vector<T> discarded;  // Destroyed after the lock is released
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!makeSpace(lock, discarded)) {
+                return false;
+            }
+            queue.push(std::move(item));
+        }
+        cond.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Push several items under one lock, applying the overflow policy to each
+     * @param items Items to push, moved out in order; the vector is cleared
+     * @return Number of items pushed, fewer than given if the queue was closed
+     */
+    size_t push_bulk(std::vector<T>& items) {
+        std::vector<T> discarded;
+        size_t pushed = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (T& item : items) {
+                if (!makeSpace(lock, discarded)) break;
+                queue.push(std::move(item));
+                pushed++;
+            }
+        }
+        items.clear();
+        cond.notify_all();
+        return pushed;
+    }
+
+    /**
+     * @brief Push an item onto the queue if there is space
+     * @param item The item to be pushed; left untouched if the queue is full
+     * @return true if the item was pushed, false if the queue is full
+     */
+    bool try_push(T&& item) {
         std::lock_guard<std::mutex> lock(mutex);
+        if (closed || (capacity != 0 && queue.size() >= capacity)) {
+            return false;
+        }
         queue.push(std::move(item));
         cond.notify_one();
+        return true;
     }
 
     /**
-     * @brief Pop an item from the queue
+     * @brief Pop an item from the queue, waiting until one is available
      * @param item Reference to store the popped item
-     * @return true if an item was successfully popped, false otherwise
+     * @return true if an item was popped, false if the queue is closed and empty
      */
     bool pop(T& item) {
         std::unique_lock<std::mutex> lock(mutex);
-        cond.wait(lock, [this] { return !queue.empty(); });
-        item = std::move(queue.front());
-        queue.pop();
+        cond.wait(lock, [this] { return closed || !queue.empty(); });
+        if (queue.empty()) {
+            return false;
+        }
+        takeFront(item);
+        return true;
+    }
+
+    /**
+     * @brief Pop an item from the queue, waiting at most a given time
+     * @param item Reference to store the popped item
+     * @param timeout Longest time to wait for an item
+     * @return true if an item was popped, false on timeout or if the queue is closed and empty
+     */
+    template<typename Rep, typename Period>
+    bool pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait_for(lock, timeout, [this] { return closed || !queue.empty(); });
+        if (queue.empty()) {
+            return false;
+        }
+        takeFront(item);
         return true;
     }
-};
\ No newline at end of file
+
+    /**
+     * @brief Pop an item from the queue if one is available
+     * @param item Reference to store the popped item
+     * @return true if an item was popped, false if the queue is empty
+     */
+    bool try_pop(T& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) {
+            return false;
+        }
+        takeFront(item);
+        return true;
+    }
+
+    /**
+     * @brief Pop up to maxItems items under one lock, waiting until at least one is available
+     * @param items Receives the popped items, appended in queue order
+     * @param maxItems Largest number of items to pop
+     * @return Number of items popped, 0 if the queue is closed and empty
+     */
+    size_t drain(std::vector<T>& items, size_t maxItems) {
+        size_t count = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [this] { return closed || !queue.empty(); });
+            while (count < maxItems && !queue.empty()) {
+                items.push_back(std::move(queue.front()));
+                queue.pop();
+                count++;
+            }
+        }
+        notFull.notify_all();
+        return count;
+    }
+
+    /**
+     * @brief Close the queue and wake every waiting producer and consumer
+     *
+     * Items already queued can still be popped.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        cond.notify_all();
+        notFull.notify_all();
+    }
+
+    /**
+     * @brief Check whether the queue was closed
+     * @return true after close()
+     */
+    bool is_closed() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return closed;
+    }
+
+    /**
+     * @brief Get the number of queued items
+     * @return The current queue length
+     */
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.size();
+    }
+
+    /**
+     * @brief Get the number of items discarded by the DROP_OLDEST policy
+     * @return Total discarded items
+     */
+    size_t dropped() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return droppedItems;
+    }
+};
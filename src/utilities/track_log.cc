@@ -0,0 +1,250 @@
+#include "track_log.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t FRAME_ALIGNMENT = 8;
+constexpr size_t WRITE_BATCH = 64;
+
+size_t paddedSize(size_t bytes) {
+    return (bytes + FRAME_ALIGNMENT - 1) / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+}
+
+template<typename T>
+T clampTo(int value) {
+    return static_cast<T>(std::clamp<int>(value, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+}
+
+} // namespace
+
+TrackLogWriter::TrackLogWriter(const std::string& path)
+    : path(path), file(path, std::ios::binary | std::ios::trunc) {
+    if (!file) {
+        LOG_ERROR("Failed to create track log %s", path.c_str());
+        return;
+    }
+
+    TrackLogFileHeader header = {};
+    std::memcpy(header.magic, TRACK_LOG_MAGIC, sizeof(header.magic));
+    header.version = TRACK_LOG_VERSION;
+    header.recordSize = sizeof(TrackLogRecord);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offset = sizeof(header);
+
+    opened = true;
+    thread = std::thread(&TrackLogWriter::run, this);
+}
+
+TrackLogWriter::~TrackLogWriter() {
+    close();
+}
+
+void TrackLogWriter::append(int64_t frameIndex, const std::vector<cv::Rect>& boxes, const std::vector<int>& ids) {
+    if (!opened || closed) return;
+
+    Entry entry;
+    entry.frameIndex = frameIndex;
+    size_t count = std::min(boxes.size(), ids.size());
+    entry.tracks.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        entry.tracks.emplace_back(ids[i], boxes[i]);
+    }
+    queue.push(std::move(entry));
+}
+
+void TrackLogWriter::close() {
+    if (!opened || closed) return;
+    closed = true;
+
+    queue.close();
+    thread.join();
+
+    TrackLogFooter footer = {};
+    footer.indexOffset = offset;
+    footer.frameCount = index.size();
+    footer.recordCount = recordCount;
+    std::memcpy(footer.magic, TRACK_LOG_FOOTER_MAGIC, sizeof(footer.magic));
+
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(TrackLogIndexEntry));
+    file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    file.close();
+
+    if (!file) {
+        LOG_ERROR("Failed to write track log %s", path.c_str());
+    } else {
+        LOG_INFO("Track log %s: %zu frames, %llu records", path.c_str(), index.size(),
+                 static_cast<unsigned long long>(recordCount));
+    }
+}
+
+void TrackLogWriter::run() {
+    // Take whatever has queued up at once, so a burst costs one lock round-trip
+    std::vector<Entry> batch;
+    while (queue.drain(batch, WRITE_BATCH) > 0) {
+        for (Entry& entry : batch) {
+            writeFrame(entry);
+        }
+        batch.clear();
+    }
+}
+
+void TrackLogWriter::writeFrame(Entry& entry) {
+    std::sort(entry.tracks.begin(), entry.tracks.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    TrackLogFrameHeader header = {};
+    header.frameIndex = entry.frameIndex;
+    header.baseID = entry.tracks.empty() ? 0 : entry.tracks.front().first;
+
+    records.clear();
+    int64_t previousID = header.baseID;
+    for (const auto& track : entry.tracks) {
+        int64_t delta = track.first - previousID;
+        while (delta >= TRACK_LOG_ID_ESCAPE) {
+            records.push_back({TRACK_LOG_ID_ESCAPE, 0, 0, 0, 0});
+            delta -= TRACK_LOG_ID_ESCAPE;
+        }
+
+        const cv::Rect& box = track.second;
+        records.push_back({static_cast<uint16_t>(delta),
+                           clampTo<int16_t>(box.x), clampTo<int16_t>(box.y),
+                           clampTo<uint16_t>(box.width), clampTo<uint16_t>(box.height)});
+        previousID = track.first;
+    }
+    header.recordCount = static_cast<uint32_t>(records.size());
+
+    index.push_back({entry.frameIndex, offset});
+
+    size_t recordBytes = records.size() * sizeof(TrackLogRecord);
+    size_t padding = paddedSize(recordBytes) - recordBytes;
+    static const char zeros[FRAME_ALIGNMENT] = {};
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), recordBytes);
+    file.write(zeros, padding);
+
+    offset += sizeof(header) + recordBytes + padding;
+    recordCount += records.size();
+}
+
+bool TrackLogReader::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open track log %s", path.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TrackLogFileHeader)) {
+        LOG_ERROR("Track log %s is too short", path.c_str());
+        ::close(fd);
+        return false;
+    }
+    mappingSize = static_cast<size_t>(st.st_size);
+
+    void* data = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map track log %s", path.c_str());
+        return false;
+    }
+
+    size_t length = mappingSize;
+    mapping = std::shared_ptr<uint8_t>(static_cast<uint8_t*>(data),
+                                       [length](uint8_t* p) { munmap(p, length); });
+
+    const auto* header = reinterpret_cast<const TrackLogFileHeader*>(mapping.get());
+    if (std::memcmp(header->magic, TRACK_LOG_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != TRACK_LOG_VERSION || header->recordSize != sizeof(TrackLogRecord)) {
+        LOG_ERROR("%s is not a version %u track log", path.c_str(), TRACK_LOG_VERSION);
+        mapping.reset();
+        return false;
+    }
+
+    complete = false;
+    if (mappingSize >= sizeof(TrackLogFileHeader) + sizeof(TrackLogFooter)) {
+        const auto* footer = reinterpret_cast<const TrackLogFooter*>(
+            mapping.get() + mappingSize - sizeof(TrackLogFooter));
+        if (std::memcmp(footer->magic, TRACK_LOG_FOOTER_MAGIC, sizeof(footer->magic)) == 0 &&
+            footer->indexOffset + footer->frameCount * sizeof(TrackLogIndexEntry) + sizeof(TrackLogFooter) ==
+                mappingSize) {
+            index = reinterpret_cast<const TrackLogIndexEntry*>(mapping.get() + footer->indexOffset);
+            indexSize = static_cast<size_t>(footer->frameCount);
+            complete = true;
+        }
+    }
+
+    if (!complete) {
+        LOG_WARNING("Track log %s has no index, it was not closed cleanly; scanning frames", path.c_str());
+        scanFrames();
+    }
+
+    sorted = std::is_sorted(index, index + indexSize,
+                            [](const TrackLogIndexEntry& a, const TrackLogIndexEntry& b) {
+                                return a.frameIndex < b.frameIndex;
+                            });
+    return true;
+}
+
+void TrackLogReader::scanFrames() {
+    scannedIndex.clear();
+    size_t position = sizeof(TrackLogFileHeader);
+    while (position + sizeof(TrackLogFrameHeader) <= mappingSize) {
+        const auto* header = reinterpret_cast<const TrackLogFrameHeader*>(mapping.get() + position);
+        size_t frameBytes = sizeof(TrackLogFrameHeader) +
+                            paddedSize(header->recordCount * sizeof(TrackLogRecord));
+        if (position + frameBytes > mappingSize) break;  // Truncated final frame
+
+        scannedIndex.push_back({header->frameIndex, position});
+        position += frameBytes;
+    }
+    index = scannedIndex.data();
+    indexSize = scannedIndex.size();
+}
+
+TrackLogReader::FrameView TrackLogReader::frame(size_t position) const {
+    const auto* header = reinterpret_cast<const TrackLogFrameHeader*>(mapping.get() + index[position].offset);
+
+    FrameView view;
+    view.frameIndex = header->frameIndex;
+    view.baseID = header->baseID;
+    view.records = reinterpret_cast<const TrackLogRecord*>(header + 1);
+    view.recordCount = header->recordCount;
+    return view;
+}
+
+long TrackLogReader::findFrame(int64_t frameIndex) const {
+    if (sorted) {
+        const TrackLogIndexEntry* end = index + indexSize;
+        const TrackLogIndexEntry* it = std::lower_bound(index, end, frameIndex,
+            [](const TrackLogIndexEntry& entry, int64_t value) { return entry.frameIndex < value; });
+        return it != end && it->frameIndex == frameIndex ? static_cast<long>(it - index) : -1;
+    }
+
+    for (size_t i = 0; i < indexSize; ++i) {
+        if (index[i].frameIndex == frameIndex) return static_cast<long>(i);
+    }
+    return -1;
+}
+
+void TrackLogReader::decode(const FrameView& view, std::vector<cv::Rect>& boxes, std::vector<int>& ids) {
+    boxes.clear();
+    ids.clear();
+
+    int64_t id = view.baseID;
+    for (uint32_t i = 0; i < view.recordCount; ++i) {
+        const TrackLogRecord& record = view.records[i];
+        id += record.idDelta;
+        if (record.idDelta == TRACK_LOG_ID_ESCAPE) continue;
+
+        boxes.emplace_back(record.x, record.y, record.width, record.height);
+        ids.push_back(static_cast<int>(id));
+    }
+}
@@ -0,0 +1,215 @@
+/**
+ * @file track_log.h
+ * @brief Compact binary log of per-frame track states with a background writer and mmap reader
+ *
+ * File layout (native little-endian):
+ *   TrackLogFileHeader
+ *   for every frame: TrackLogFrameHeader, recordCount x TrackLogRecord, zero padding to 8 bytes
+ *   frameCount x TrackLogIndexEntry
+ *   TrackLogFooter
+ *
+ * Records of a frame are sorted by track ID and store the ID as the difference to
+ * the previous record (the first one relative to the frame's baseID). Differences
+ * that do not fit in 16 bits are carried by escape records without a box. The
+ * index table and footer are written on close; a log without them (writer killed)
+ * is still readable by scanning the frames.
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "thread_safe_queue.h"
+
+constexpr char TRACK_LOG_MAGIC[8] = {'T', 'R', 'K', 'L', 'O', 'G', '0', '1'};
+constexpr char TRACK_LOG_FOOTER_MAGIC[8] = {'T', 'R', 'K', 'I', 'D', 'X', '0', '1'};
+constexpr uint32_t TRACK_LOG_VERSION = 1;
+constexpr uint16_t TRACK_LOG_ID_ESCAPE = 0xFFFF;  ///< idDelta of a record that only advances the ID
+
+struct TrackLogFileHeader {
+    char magic[8];           ///< TRACK_LOG_MAGIC
+    uint32_t version;        ///< TRACK_LOG_VERSION
+    uint32_t recordSize;     ///< sizeof(TrackLogRecord)
+};
+
+struct TrackLogFrameHeader {
+    int64_t frameIndex;      ///< Frame::frameIndex of the source frame
+    uint32_t recordCount;    ///< Records following this header, including escapes
+    int32_t baseID;          ///< Smallest track ID in the frame
+};
+
+struct TrackLogRecord {
+    uint16_t idDelta;        ///< Track ID minus the previous record's ID, or TRACK_LOG_ID_ESCAPE
+    int16_t x;               ///< Box left edge
+    int16_t y;               ///< Box top edge
+    uint16_t width;          ///< Box width
+    uint16_t height;         ///< Box height
+};
+
+struct TrackLogIndexEntry {
+    int64_t frameIndex;      ///< Frame::frameIndex of the frame
+    uint64_t offset;         ///< File offset of the frame's TrackLogFrameHeader
+};
+
+struct TrackLogFooter {
+    uint64_t indexOffset;    ///< File offset of the index table
+    uint64_t frameCount;     ///< Entries in the index table
+    uint64_t recordCount;    ///< Total records in the file
+    char magic[8];           ///< TRACK_LOG_FOOTER_MAGIC
+};
+
+static_assert(sizeof(TrackLogFileHeader) == 16, "unexpected TrackLogFileHeader layout");
+static_assert(sizeof(TrackLogFrameHeader) == 16, "unexpected TrackLogFrameHeader layout");
+static_assert(sizeof(TrackLogRecord) == 10, "unexpected TrackLogRecord layout");
+static_assert(sizeof(TrackLogIndexEntry) == 16, "unexpected TrackLogIndexEntry layout");
+static_assert(sizeof(TrackLogFooter) == 32, "unexpected TrackLogFooter layout");
+
+/**
+ * @class TrackLogWriter
+ * @brief Appends frames to a track log from a background thread
+ *
+ * append() only copies the boxes and IDs into a queue; sorting, encoding and file
+ * I/O happen on the writer thread.
+ */
+class TrackLogWriter {
+public:
+    /**
+     * @brief Create the file, write its header and start the writer thread
+     * @param path Log file to create (truncated if it exists)
+     */
+    explicit TrackLogWriter(const std::string& path);
+
+    /**
+     * @brief Destructor, closes the log
+     */
+    ~TrackLogWriter();
+
+    TrackLogWriter(const TrackLogWriter&) = delete;
+    TrackLogWriter& operator=(const TrackLogWriter&) = delete;
+
+    /**
+     * @brief Check whether the file was created
+     * @return true if frames are being written
+     */
+    bool isOpen() const { return opened; }
+
+    /**
+     * @brief Queue the track state of one frame
+     * @param frameIndex Position of the frame in the source stream
+     * @param boxes Track boxes
+     * @param ids Track IDs matching boxes
+     */
+    void append(int64_t frameIndex, const std::vector<cv::Rect>& boxes, const std::vector<int>& ids);
+
+    /**
+     * @brief Write the queued frames, the index table and the footer, then close the file
+     */
+    void close();
+
+private:
+    struct Entry {
+        int64_t frameIndex = 0;
+        std::vector<std::pair<int, cv::Rect>> tracks;
+    };
+
+    /**
+     * @brief Writer loop run by the background thread
+     */
+    void run();
+
+    /**
+     * @brief Encode and write one frame
+     */
+    void writeFrame(Entry& entry);
+
+    std::string path;                         ///< Log file
+    std::ofstream file;                       ///< Output stream, used by the writer thread only
+    bool opened = false;                      ///< File was created
+    bool closed = false;                      ///< close() has already run
+    ThreadSafeQueue<Entry> queue;             ///< Frames waiting to be written
+    std::thread thread;                       ///< Writer thread
+    std::vector<TrackLogIndexEntry> index;    ///< Index table, written on close
+    std::vector<TrackLogRecord> records;      ///< Reused encoding buffer
+    uint64_t offset = 0;                      ///< Current file offset
+    uint64_t recordCount = 0;                 ///< Records written so far
+};
+
+/**
+ * @class TrackLogReader
+ * @brief Read-only memory-mapped access to a track log
+ *
+ * Frame views point straight into the mapping; nothing is copied until decode().
+ */
+class TrackLogReader {
+public:
+    /**
+     * @struct FrameView
+     * @brief One frame of the log, referring to the mapped records
+     */
+    struct FrameView {
+        int64_t frameIndex = -1;                ///< Frame::frameIndex of the frame
+        int32_t baseID = 0;                     ///< ID the first record's delta is relative to
+        const TrackLogRecord* records = nullptr;///< Records of the frame, including escapes
+        uint32_t recordCount = 0;               ///< Number of records
+    };
+
+    /**
+     * @brief Map a log file and locate its frames
+     * @param path Log file to read
+     * @return false if the file cannot be mapped or has no valid header
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Check whether the log was closed properly
+     * @return true if the index table came from the footer, false if the frames were scanned
+     */
+    bool isComplete() const { return complete; }
+
+    /**
+     * @brief Get the number of frames in the log
+     * @return Number of frames
+     */
+    size_t frameCount() const { return indexSize; }
+
+    /**
+     * @brief Get a frame by its position in the log
+     * @param position Frame position, less than frameCount()
+     * @return View of the frame
+     */
+    FrameView frame(size_t position) const;
+
+    /**
+     * @brief Find the position of a source frame
+     * @param frameIndex Frame::frameIndex to look up
+     * @return Position in the log, or -1 if the frame was not logged
+     */
+    long findFrame(int64_t frameIndex) const;
+
+    /**
+     * @brief Expand a frame into boxes and track IDs
+     * @param view Frame to decode
+     * @param boxes Receives the boxes
+     * @param ids Receives the track IDs
+     */
+    static void decode(const FrameView& view, std::vector<cv::Rect>& boxes, std::vector<int>& ids);
+
+private:
+    /**
+     * @brief Rebuild the index table by walking the frames of an unterminated log
+     */
+    void scanFrames();
+
+    std::shared_ptr<uint8_t> mapping;               ///< Mapped file, unmapped by the last owner
+    size_t mappingSize = 0;                         ///< Length of the mapping
+    const TrackLogIndexEntry* index = nullptr;      ///< Index table, in the mapping or scannedIndex
+    size_t indexSize = 0;                           ///< Entries in the index table
+    std::vector<TrackLogIndexEntry> scannedIndex;   ///< Index rebuilt by scanFrames()
+    bool complete = false;                          ///< Footer and index table were present
+    bool sorted = true;                             ///< Frame indices are ascending
+};
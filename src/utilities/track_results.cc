@@ -0,0 +1,218 @@
+#include "track_results.h"
+#include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Atomics shared between processes must be lock-free");
+
+// A reader gives up on a slot after this many torn copies; the writer must have lapped it meanwhile
+const int MAX_READ_ATTEMPTS = 16;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t slotsOffset() {
+    return alignUp(sizeof(TrackResultsHeader), alignof(TrackResultsSlot));
+}
+
+size_t slotBytes(uint32_t maxTracks) {
+    return alignUp(sizeof(TrackResultsSlot) + maxTracks * sizeof(TrackRecord), alignof(TrackResultsSlot));
+}
+
+TrackRecord* slotRecords(TrackResultsSlot* slot) {
+    return reinterpret_cast<TrackRecord*>(slot + 1);
+}
+
+const TrackRecord* slotRecords(const TrackResultsSlot* slot) {
+    return reinterpret_cast<const TrackRecord*>(slot + 1);
+}
+
+} // namespace
+
+TrackResultsWriter::TrackResultsWriter(const std::string& name, uint8_t* base, size_t size)
+    : name(name), base(base), size(size), header(reinterpret_cast<TrackResultsHeader*>(base)) {
+}
+
+TrackResultsWriter::~TrackResultsWriter() {
+    header->closed.store(1, std::memory_order_release);
+    munmap(base, size);
+    shm_unlink(name.c_str());
+}
+
+std::unique_ptr<TrackResultsWriter> TrackResultsWriter::create(const std::string& name, uint32_t slotCount,
+                                                               uint32_t maxTracks) {
+    if (slotCount == 0 || maxTracks == 0) {
+        LOG_ERROR("Results ring %s needs at least one slot and one track per slot", name.c_str());
+        return nullptr;
+    }
+
+    size_t size = slotsOffset() + slotCount * slotBytes(maxTracks);
+
+    // Readers still mapping a ring left behind by a previous run keep their copy
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Failed to create shared memory %s: %s", name.c_str(), std::strerror(errno));
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        LOG_ERROR("Failed to size shared memory %s: %s", name.c_str(), std::strerror(errno));
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map shared memory %s: %s", name.c_str(), std::strerror(errno));
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    uint8_t* base = static_cast<uint8_t*>(data);
+    TrackResultsHeader* header = new (base) TrackResultsHeader();
+    header->version = VERSION;
+    header->slotCount = slotCount;
+    header->maxTracks = maxTracks;
+    header->slotBytes = slotBytes(maxTracks);
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        new (base + slotsOffset() + i * header->slotBytes) TrackResultsSlot();
+    }
+
+    // Readers check the magic first, so it is written once everything else is in place
+    reinterpret_cast<std::atomic<uint32_t>*>(&header->magic)->store(MAGIC, std::memory_order_release);
+
+    LOG_INFO("Publishing tracking results to %s: %u frames of up to %u tracks", name.c_str(), slotCount, maxTracks);
+    return std::unique_ptr<TrackResultsWriter>(new TrackResultsWriter(name, base, size));
+}
+
+uint64_t TrackResultsWriter::publish(int64_t frameIndex, int64_t captureTimeNs, uint32_t frameWidth,
+                                     uint32_t frameHeight, const TrackRecord* tracks, size_t count) {
+    if (count > header->maxTracks) {
+        if (!truncated) {
+            LOG_WARNING("Frame %lld has %zu tracks, publishing the first %u", static_cast<long long>(frameIndex), count,
+                        header->maxTracks);
+            truncated = true;
+        }
+        count = header->maxTracks;
+    }
+
+    uint64_t sequence = next++;
+    TrackResultsSlot* slot = reinterpret_cast<TrackResultsSlot*>(
+        base + slotsOffset() + ((sequence - 1) % header->slotCount) * header->slotBytes);
+
+    // Odd counter: readers copying this slot now will discard their copy
+    uint64_t seqlock = slot->seqlock.load(std::memory_order_relaxed);
+    slot->seqlock.store(seqlock + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->sequence = sequence;
+    slot->frameIndex = frameIndex;
+    slot->captureTimeNs = captureTimeNs;
+    slot->publishTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    slot->frameWidth = frameWidth;
+    slot->frameHeight = frameHeight;
+    slot->trackCount = static_cast<uint32_t>(count);
+    if (count > 0) {
+        std::memcpy(slotRecords(slot), tracks, count * sizeof(TrackRecord));
+    }
+
+    slot->seqlock.store(seqlock + 2, std::memory_order_release);
+    header->latest.store(sequence, std::memory_order_release);
+    return sequence;
+}
+
+TrackResultsReader::TrackResultsReader(const uint8_t* base, size_t size)
+    : base(base), size(size), header(reinterpret_cast<const TrackResultsHeader*>(base)) {
+}
+
+TrackResultsReader::~TrackResultsReader() {
+    munmap(const_cast<uint8_t*>(base), size);
+}
+
+std::unique_ptr<TrackResultsReader> TrackResultsReader::attach(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;  // The writer has not created the ring yet
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TrackResultsHeader)) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const uint8_t* base = static_cast<const uint8_t*>(data);
+    const TrackResultsHeader* header = reinterpret_cast<const TrackResultsHeader*>(base);
+    uint32_t magic = reinterpret_cast<const std::atomic<uint32_t>*>(&header->magic)->load(std::memory_order_acquire);
+    if (magic != TrackResultsWriter::MAGIC || header->version != TrackResultsWriter::VERSION ||
+        header->slotCount == 0 || header->slotBytes < slotBytes(header->maxTracks) ||
+        size < slotsOffset() + header->slotCount * header->slotBytes) {
+        munmap(data, size);
+        return nullptr;
+    }
+    return std::unique_ptr<TrackResultsReader>(new TrackResultsReader(base, size));
+}
+
+bool TrackResultsReader::readLatest(TrackResultsFrame& frame) {
+    // If the newest frame is overwritten while copying it, an even newer one exists
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t sequence = latest();
+        if (sequence == 0) return false;
+        if (read(sequence, frame)) return true;
+    }
+    return false;
+}
+
+bool TrackResultsReader::read(uint64_t sequence, TrackResultsFrame& frame) {
+    if (sequence == 0 || sequence > latest()) {
+        return false;
+    }
+    const TrackResultsSlot* slot = reinterpret_cast<const TrackResultsSlot*>(
+        base + slotsOffset() + ((sequence - 1) % header->slotCount) * header->slotBytes);
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t before = slot->seqlock.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();  // The writer is in the middle of this slot
+            continue;
+        }
+
+        frame.sequence = slot->sequence;
+        frame.frameIndex = slot->frameIndex;
+        frame.captureTimeNs = slot->captureTimeNs;
+        frame.publishTimeNs = slot->publishTimeNs;
+        frame.frameWidth = slot->frameWidth;
+        frame.frameHeight = slot->frameHeight;
+        // A torn count may be anything, so bound it before copying
+        uint32_t count = std::min(slot->trackCount, header->maxTracks);
+        frame.tracks.resize(count);
+        if (count > 0) {
+            std::memcpy(frame.tracks.data(), slotRecords(slot), count * sizeof(TrackRecord));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seqlock.load(std::memory_order_relaxed) == before) {
+            return frame.sequence == sequence;  // A different sequence means the slot was reused
+        }
+        torn++;
+    }
+    return false;
+}
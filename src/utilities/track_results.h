@@ -0,0 +1,201 @@
+/**
+ * @file track_results.h
+ * @brief Shared-memory seqlock ring of per-frame tracking results, with its writer and reader
+ *
+ * Depends only on the C++ standard library and POSIX, so analytics processes can
+ * link the reader without OpenCV or ONNX Runtime.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TrackRecord
+ * @brief One track on one frame
+ */
+struct TrackRecord {
+    int32_t trackId;  ///< Track ID
+    int32_t x;        ///< Left edge of the box in frame pixels
+    int32_t y;        ///< Top edge of the box in frame pixels
+    int32_t width;    ///< Box width
+    int32_t height;   ///< Box height
+    float score;      ///< Detection confidence, 0 if unknown
+};
+
+/**
+ * @struct TrackResultsFrame
+ * @brief Tracks of one frame as read from the ring
+ */
+struct TrackResultsFrame {
+    uint64_t sequence = 0;            ///< Position of the frame among published frames, starting at 1
+    int64_t frameIndex = -1;          ///< Position of the frame in the source stream
+    int64_t captureTimeNs = 0;        ///< Capture time on the steady (CLOCK_MONOTONIC) clock
+    int64_t publishTimeNs = 0;        ///< Publication time on the same clock
+    uint32_t frameWidth = 0;          ///< Width of the frame the boxes refer to
+    uint32_t frameHeight = 0;         ///< Height of the frame the boxes refer to
+    std::vector<TrackRecord> tracks;  ///< Tracks on the frame
+};
+
+/**
+ * @struct TrackResultsHeader
+ * @brief Start of the shared-memory object; the slots follow
+ */
+struct alignas(64) TrackResultsHeader {
+    uint32_t magic;                ///< TrackResultsWriter::MAGIC once the ring is initialized
+    uint32_t version;              ///< TrackResultsWriter::VERSION
+    uint32_t slotCount;            ///< Number of slots
+    uint32_t maxTracks;            ///< Track capacity of a slot
+    uint64_t slotBytes;            ///< Distance between slots
+    std::atomic<uint64_t> latest;  ///< Sequence of the newest complete frame, 0 before the first
+    std::atomic<uint32_t> closed;  ///< Nonzero once the writer stopped
+};
+
+/**
+ * @struct TrackResultsSlot
+ * @brief One frame's results, followed by maxTracks TrackRecords
+ *
+ * The seqlock counter is odd while the writer updates the slot. A reader copies
+ * the slot between two reads of the counter and retries if they differ.
+ */
+struct alignas(64) TrackResultsSlot {
+    std::atomic<uint64_t> seqlock;  ///< Odd while the slot is being written
+    uint64_t sequence;              ///< Sequence of the frame in the slot
+    int64_t frameIndex;             ///< Position of the frame in the source stream
+    int64_t captureTimeNs;          ///< Capture time on the steady clock
+    int64_t publishTimeNs;          ///< Publication time on the steady clock
+    uint32_t frameWidth;            ///< Frame width
+    uint32_t frameHeight;           ///< Frame height
+    uint32_t trackCount;            ///< Records in use
+    uint32_t reserved;
+};
+
+/**
+ * @class TrackResultsWriter
+ * @brief Creates the results ring and publishes frames into it
+ *
+ * Publishing never waits: the writer overwrites the oldest slot, and readers that
+ * were copying it notice and retry. Only one writer may exist per ring.
+ */
+class TrackResultsWriter {
+public:
+    static constexpr uint32_t MAGIC = 0x53525254;  ///< "TRRS"
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * @brief Create a ring, replacing a stale one of the same name
+     * @param name Shared-memory object name, starting with '/'
+     * @param slotCount Number of frames kept
+     * @param maxTracks Track capacity of a slot
+     * @return The writer, or null on failure
+     */
+    static std::unique_ptr<TrackResultsWriter> create(const std::string& name, uint32_t slotCount, uint32_t maxTracks);
+
+    /**
+     * @brief Mark the ring closed, unmap it and remove the name
+     */
+    ~TrackResultsWriter();
+
+    TrackResultsWriter(const TrackResultsWriter&) = delete;
+    TrackResultsWriter& operator=(const TrackResultsWriter&) = delete;
+
+    /**
+     * @brief Publish the tracks of one frame
+     * @param frameIndex Position of the frame in the source stream
+     * @param captureTimeNs Capture time on the steady clock
+     * @param frameWidth Width of the frame
+     * @param frameHeight Height of the frame
+     * @param tracks Tracks on the frame; records beyond the slot capacity are left out
+     * @param count Number of tracks
+     * @return Sequence number of the published frame
+     */
+    uint64_t publish(int64_t frameIndex, int64_t captureTimeNs, uint32_t frameWidth, uint32_t frameHeight,
+                     const TrackRecord* tracks, size_t count);
+
+private:
+    TrackResultsWriter(const std::string& name, uint8_t* base, size_t size);
+
+    std::string name;             ///< Shared-memory object name
+    uint8_t* base;                ///< Start of the mapping
+    size_t size;                  ///< Length of the mapping
+    TrackResultsHeader* header;   ///< Ring header at the start of the mapping
+    uint64_t next = 1;            ///< Sequence of the next frame
+    bool truncated = false;       ///< A frame had more tracks than a slot holds
+};
+
+/**
+ * @class TrackResultsReader
+ * @brief Read-only view of a results ring
+ *
+ * Any number of readers may attach; they map the ring read-only and never block
+ * the writer or each other.
+ */
+class TrackResultsReader {
+public:
+    /**
+     * @brief Attach to a ring
+     * @param name Shared-memory object name used by the writer
+     * @return The reader, or null if the ring does not exist or is not compatible
+     */
+    static std::unique_ptr<TrackResultsReader> attach(const std::string& name);
+
+    /**
+     * @brief Unmap the ring
+     */
+    ~TrackResultsReader();
+
+    TrackResultsReader(const TrackResultsReader&) = delete;
+    TrackResultsReader& operator=(const TrackResultsReader&) = delete;
+
+    /**
+     * @brief Get the sequence of the newest published frame
+     * @return Sequence number, 0 before the first frame
+     */
+    uint64_t latest() const { return header->latest.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Copy the newest frame
+     * @param frame Receives the frame
+     * @return false if nothing was published yet or the writer kept overwriting the slot
+     */
+    bool readLatest(TrackResultsFrame& frame);
+
+    /**
+     * @brief Copy a specific frame, for readers that follow every frame
+     * @param sequence Sequence number of the frame
+     * @param frame Receives the frame
+     * @return false if the frame is not published yet or was already overwritten; compare with latest()
+     */
+    bool read(uint64_t sequence, TrackResultsFrame& frame);
+
+    /**
+     * @brief Get the number of frames the ring keeps
+     * @return Slot count
+     */
+    uint32_t slotCount() const { return header->slotCount; }
+
+    /**
+     * @brief Check whether the writer stopped
+     * @return true once the writer was destroyed
+     */
+    bool isClosed() const { return header->closed.load(std::memory_order_acquire) != 0; }
+
+    /**
+     * @brief Get the number of copies discarded because the writer changed the slot meanwhile
+     * @return Torn read count of this reader
+     */
+    uint64_t tornReads() const { return torn; }
+
+private:
+    TrackResultsReader(const uint8_t* base, size_t size);
+
+    const uint8_t* base;                ///< Start of the mapping
+    size_t size;                        ///< Length of the mapping
+    const TrackResultsHeader* header;   ///< Ring header at the start of the mapping
+    uint64_t torn = 0;                  ///< Copies discarded as torn
+};
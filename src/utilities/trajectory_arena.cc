@@ -0,0 +1,54 @@
+#include "trajectory_arena.h"
+#include <algorithm>
+
+TrajectoryArena::TrajectoryArena(size_t length, size_t slabSlots)
+    : length(std::max<size_t>(1, length)), slabSlots(std::max<size_t>(1, slabSlots)) {}
+
+int TrajectoryArena::acquire() {
+    if (freeSlots.empty()) {
+        grow();
+    }
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+    slots[slot].start = 0;
+    slots[slot].count = 0;
+    return slot;
+}
+
+void TrajectoryArena::release(int slot) {
+    if (slot < 0 || static_cast<size_t>(slot) >= slots.size()) return;
+    freeSlots.push_back(slot);
+}
+
+void TrajectoryArena::append(int slot, const TrajectoryPoint& point) {
+    Slot& ring = slots[slot];
+    if (ring.count < length) {
+        ring.points[(ring.start + ring.count) % length] = point;
+        ring.count++;
+    } else {
+        ring.points[ring.start] = point;
+        ring.start = (ring.start + 1) % length;
+    }
+}
+
+TrajectoryView TrajectoryArena::view(int slot) const {
+    if (slot < 0 || static_cast<size_t>(slot) >= slots.size()) return TrajectoryView();
+    const Slot& ring = slots[slot];
+    return TrajectoryView(ring.points, length, ring.start, ring.count);
+}
+
+void TrajectoryArena::grow() {
+    slabs.push_back(std::make_unique<TrajectoryPoint[]>(length * slabSlots));
+    TrajectoryPoint* slab = slabs.back().get();
+
+    size_t first = slots.size();
+    slots.resize(first + slabSlots);
+    freeSlots.reserve(slots.size());
+    for (size_t i = 0; i < slabSlots; ++i) {
+        slots[first + i].points = slab + i * length;
+    }
+    // Hand out low slots first
+    for (size_t i = slabSlots; i-- > 0;) {
+        freeSlots.push_back(static_cast<int>(first + i));
+    }
+}
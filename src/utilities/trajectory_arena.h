@@ -0,0 +1,143 @@
+/**
+ * @file trajectory_arena.h
+ * @brief Fixed-capacity trajectory ring buffers allocated from slabs
+ */
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @struct TrajectoryPoint
+ * @brief State of a track on one frame
+ */
+struct TrajectoryPoint {
+    cv::Rect box;                                     ///< Bounding box in original image coordinates
+    std::chrono::steady_clock::time_point timestamp;  ///< Capture time of the frame
+    int64_t frameIndex = -1;                          ///< Position of the frame in the source stream
+    float score = 0.0f;                               ///< Detection confidence, 0 if unknown
+};
+
+/**
+ * @class TrajectoryView
+ * @brief Read-only view of one trajectory ring, oldest point first
+ *
+ * Refers to arena memory; valid until the trajectory is appended to or released.
+ */
+class TrajectoryView {
+public:
+    TrajectoryView() = default;
+    TrajectoryView(const TrajectoryPoint* points, size_t capacity, size_t start, size_t count)
+        : points(points), capacity(capacity), start(start), count(count) {}
+
+    /**
+     * @brief Get the number of recorded points
+     * @return Point count, at most the ring capacity
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Check whether no point was recorded
+     * @return true if empty
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Access a point by age
+     * @param index 0 for the oldest recorded point, size() - 1 for the newest
+     * @return The point
+     */
+    const TrajectoryPoint& operator[](size_t index) const { return points[(start + index) % capacity]; }
+
+    /**
+     * @brief Get the newest point; the view must not be empty
+     * @return The point
+     */
+    const TrajectoryPoint& back() const { return (*this)[count - 1]; }
+
+private:
+    const TrajectoryPoint* points = nullptr;
+    size_t capacity = 0;
+    size_t start = 0;
+    size_t count = 0;
+};
+
+/**
+ * @class TrajectoryArena
+ * @brief Pool of fixed-capacity trajectory rings
+ *
+ * Rings are carved from slabs of several rings at once and handed out as slot
+ * numbers. Released slots are reused before a new slab is allocated, so memory
+ * stays at the peak number of live trajectories and appending never allocates.
+ * Slabs never move, so views stay valid while their slot is live.
+ */
+class TrajectoryArena {
+public:
+    /**
+     * @brief Constructor for the TrajectoryArena class
+     * @param length Points kept per trajectory; older points are overwritten
+     * @param slabSlots Trajectories allocated together when the arena grows
+     */
+    explicit TrajectoryArena(size_t length, size_t slabSlots = 64);
+
+    /**
+     * @brief Take an empty trajectory
+     * @return Slot number of the trajectory
+     */
+    int acquire();
+
+    /**
+     * @brief Return a trajectory for reuse
+     * @param slot Slot number from acquire()
+     */
+    void release(int slot);
+
+    /**
+     * @brief Record a point, overwriting the oldest one if the ring is full
+     * @param slot Slot number from acquire()
+     * @param point State to record
+     */
+    void append(int slot, const TrajectoryPoint& point);
+
+    /**
+     * @brief View a trajectory without copying it
+     * @param slot Slot number from acquire()
+     * @return View of the recorded points, oldest first
+     */
+    TrajectoryView view(int slot) const;
+
+    /**
+     * @brief Get the number of trajectories currently acquired
+     * @return Live slot count
+     */
+    size_t live() const { return slots.size() - freeSlots.size(); }
+
+    /**
+     * @brief Get the number of trajectories the allocated slabs hold
+     * @return Slot capacity
+     */
+    size_t capacity() const { return slots.size(); }
+
+private:
+    struct Slot {
+        TrajectoryPoint* points = nullptr;  ///< First point of the ring inside its slab
+        size_t start = 0;                   ///< Index of the oldest point
+        size_t count = 0;                   ///< Points recorded, at most length
+    };
+
+    /**
+     * @brief Allocate another slab and add its slots to the free list
+     */
+    void grow();
+
+    size_t length;                                          ///< Points per ring
+    size_t slabSlots;                                       ///< Rings per slab
+    std::vector<std::unique_ptr<TrajectoryPoint[]>> slabs;  ///< Point storage
+    std::vector<Slot> slots;                                ///< Ring state per slot
+    std::vector<int> freeSlots;                             ///< Slots ready for acquire()
+};
@@ -0,0 +1,99 @@
+/**
+ * @file work_stealing_pool.h
+ * @brief Thread pool with per-worker task deques and work stealing
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed set of worker threads that run submitted tasks
+ *
+ * Every worker owns a deque. A task submitted from a worker goes to the back of
+ * that worker's deque and is popped from the back again (LIFO), so a chain of
+ * follow-up tasks stays on the core whose cache holds its data. Tasks submitted
+ * from other threads are spread round-robin. An idle worker steals from the
+ * front (FIFO) of the other deques before going to sleep.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Start the workers
+     * @param threads Number of workers, 0 for one per hardware thread
+     */
+    explicit WorkStealingPool(size_t threads = 0);
+
+    /**
+     * @brief Destructor, runs the remaining tasks and stops the workers
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Queue a task
+     * @param task Task to run on one of the workers
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Run the tasks still queued, then stop and join the workers
+     *
+     * Tasks submitted by running tasks are still executed. No task may be
+     * submitted from outside the pool after stop() was called.
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of workers
+     * @return Worker count
+     */
+    size_t size() const { return workers.size(); }
+
+    /**
+     * @brief Get the number of tasks taken from another worker's deque
+     * @return Steal count since the pool started
+     */
+    uint64_t stolen() const { return stealCount.load(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;            ///< Guards tasks
+        std::deque<Task> tasks;      ///< Owner pops the back, thieves the front
+    };
+
+    /**
+     * @brief Worker loop
+     * @param index Index of the worker's deque
+     */
+    void run(size_t index);
+
+    /**
+     * @brief Take a task from the worker's own deque or steal one
+     * @return false if every deque was empty
+     */
+    bool take(size_t index, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;   ///< One deque per worker thread
+    std::vector<std::thread> threads;               ///< Worker threads
+    std::mutex sleepMutex;                          ///< Guards queued changes that wake sleepers
+    std::condition_variable wake;                   ///< Signalled when a task is queued or the pool stops
+    std::atomic<size_t> queued{0};                  ///< Tasks in all deques
+    std::atomic<size_t> nextWorker{0};              ///< Round-robin target for external submissions
+    std::atomic<uint64_t> stealCount{0};            ///< Tasks taken from another worker
+    bool stopping = false;                          ///< stop() was called, guarded by sleepMutex
+};
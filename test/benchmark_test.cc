@@ -0,0 +1,20 @@
+#include "unit_test.h"
+#include "benchmark.h"
+
+TEST(EscapeJSONQuotesAndControl) {
+    ASSERT_EQUAL(BenchmarkReport::escapeJSON("plain.mp4"), std::string("plain.mp4"));
+    ASSERT_EQUAL(BenchmarkReport::escapeJSON("a\"b\\c"), std::string("a\\\"b\\\\c"));
+    ASSERT_EQUAL(BenchmarkReport::escapeJSON("a\nb\tc\x01"), std::string("a\\u000ab\\u0009c\\u0001"));
+}
+
+TEST(BenchmarkJSONEscapesVideo) {
+    BenchmarkOptions options;
+    options.videoPath = "clips/line\nbreak.mp4";
+    BenchmarkReport report;
+    report.addPass(10, 1.0);
+    std::string json = report.toJSON(options);
+
+    // Every raw newline ends a line of the document, none is inside a string
+    ASSERT_TRUE(json.find("\"video\": \"clips/line\\u000abreak.mp4\",\n") != std::string::npos);
+    ASSERT_TRUE(json.find("\"frames\": 10,") != std::string::npos);
+}
@@ -0,0 +1,97 @@
+#include "unit_test.h"
+#include "config.h"
+#include "config_watcher.h"
+#include <filesystem>
+#include <fstream>
+
+static std::string writeConfig(const char* name, const std::string& contents) {
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream file(path, std::ios::trunc);
+    file << contents;
+    return path;
+}
+
+TEST(ConfigReloadRuntimeKeys) {
+    RuntimeSettings saved = Config::runtime();
+    std::string path = writeConfig("config_reload_keys.ini",
+                                   "[Tracking]\niou_threshold = 0.45\n");
+    ASSERT_TRUE(Config::reloadRuntimeSettings(path));
+
+    writeConfig("config_reload_keys.ini",
+                "[Model]\nconfidence_threshold = 0.3\n"
+                "[Tracking]\ndetection_interval = 4 ; every fourth frame\n");
+    ASSERT_TRUE(Config::reloadRuntimeSettings(path));
+    ASSERT_EQUAL(Config::getConfidenceThreshold(), 0.3f);
+    ASSERT_EQUAL(Config::getDetectionInterval(), 4);
+    // Keys missing from the file keep their running values
+    ASSERT_EQUAL(Config::getIoUThreshold(), 0.45f);
+
+    std::filesystem::remove(path);
+    Config::setRuntimeSettings(saved);
+}
+
+TEST(ConfigReloadKeepsOnError) {
+    RuntimeSettings saved = Config::runtime();
+    std::string path = writeConfig("config_reload_error.ini", "[Tracking]\ndetection_interval = 2\n");
+    ASSERT_TRUE(Config::reloadRuntimeSettings(path));
+
+    writeConfig("config_reload_error.ini", "[Tracking]\ndetection_interval = 0\n");
+    ASSERT_FALSE(Config::reloadRuntimeSettings(path));
+    writeConfig("config_reload_error.ini", "[Model]\nconfidence_threshold = high\n");
+    ASSERT_FALSE(Config::reloadRuntimeSettings(path));
+    ASSERT_EQUAL(Config::getDetectionInterval(), 2);
+
+    std::filesystem::remove(path);
+    Config::setRuntimeSettings(saved);
+}
+
+TEST(ConfigReloadRejectsTruncated) {
+    RuntimeSettings saved = Config::runtime();
+    std::string path = writeConfig("config_reload_empty.ini", "[Tracking]\ndetection_interval = 3\n");
+    ASSERT_TRUE(Config::reloadRuntimeSettings(path));
+
+    // An editor truncated the file and has only written part of it back
+    writeConfig("config_reload_empty.ini", "");
+    ASSERT_FALSE(Config::reloadRuntimeSettings(path));
+    writeConfig("config_reload_empty.ini", "[Model]\nmodel_path = model.onnx\n[Track");
+    ASSERT_FALSE(Config::reloadRuntimeSettings(path));
+    ASSERT_EQUAL(Config::getDetectionInterval(), 3);
+
+    std::filesystem::remove(path);
+    Config::setRuntimeSettings(saved);
+}
+
+TEST(ConfigWatcherSeesRewrite) {
+    RuntimeSettings saved = Config::runtime();
+    std::string path = writeConfig("config_reload_watch.ini", "[Tracking]\niou_threshold = 0.4\n");
+    ConfigWatcher watcher(path, std::chrono::milliseconds(10));
+    ASSERT_FALSE(watcher.poll());
+
+    // The change is applied once a second check sees the file unchanged
+    writeConfig("config_reload_watch.ini", "[Tracking]\niou_threshold = 0.25\n");
+    ASSERT_FALSE(watcher.poll());
+    ASSERT_TRUE(watcher.poll());
+    ASSERT_EQUAL(Config::getIoUThreshold(), 0.25f);
+    ASSERT_FALSE(watcher.poll());
+
+    std::filesystem::remove(path);
+    Config::setRuntimeSettings(saved);
+}
+
+TEST(ConfigWatcherWaitsForSave) {
+    RuntimeSettings saved = Config::runtime();
+    std::string path = writeConfig("config_reload_settle.ini", "[Tracking]\niou_threshold = 0.4\n");
+    ConfigWatcher watcher(path, std::chrono::milliseconds(10));
+
+    // Still growing between checks: nothing is read until it stops
+    writeConfig("config_reload_settle.ini", "[Tracking]\n");
+    ASSERT_FALSE(watcher.poll());
+    writeConfig("config_reload_settle.ini", "[Tracking]\niou_threshold = 0.35\n");
+    ASSERT_FALSE(watcher.poll());
+    ASSERT_EQUAL(Config::getIoUThreshold(), saved.iouThreshold);
+    ASSERT_TRUE(watcher.poll());
+    ASSERT_EQUAL(Config::getIoUThreshold(), 0.35f);
+
+    std::filesystem::remove(path);
+    Config::setRuntimeSettings(saved);
+}
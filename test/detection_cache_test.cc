@@ -0,0 +1,94 @@
+#include "unit_test.h"
+#include "detection_cache.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+static fs::path makeCacheFixture() {
+    fs::path dir = fs::temp_directory_path() / "detection_cache_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    std::ofstream(dir / "video.mp4", std::ios::binary) << std::string(4096, 'v');
+    std::ofstream(dir / "model.onnx", std::ios::binary) << std::string(1024, 'm');
+    return dir;
+}
+
+TEST(DetectionCacheKey) {
+    fs::path dir = makeCacheFixture();
+    std::string video = (dir / "video.mp4").string();
+    std::string model = (dir / "model.onnx").string();
+
+    std::string key = DetectionCache::computeKey(video, model, cv::Size(640, 640), 0.5f);
+    ASSERT_EQUAL(key.size(), 16u);
+    ASSERT_TRUE(key == DetectionCache::computeKey(video, model, cv::Size(640, 640), 0.5f));
+    ASSERT_FALSE(key == DetectionCache::computeKey(video, model, cv::Size(320, 320), 0.5f));
+    ASSERT_FALSE(key == DetectionCache::computeKey(video, model, cv::Size(640, 640), 0.6f));
+    ASSERT_TRUE(DetectionCache::computeKey(video, (dir / "missing.onnx").string(), cv::Size(640, 640), 0.5f).empty());
+
+    fs::remove_all(dir);
+}
+
+TEST(DetectionCacheRecordAndHit) {
+    fs::path dir = makeCacheFixture();
+    std::string video = (dir / "video.mp4").string();
+    std::string model = (dir / "model.onnx").string();
+    DetectionCache& cache = DetectionCache::getInstance();
+
+    ASSERT_FALSE(cache.open((dir / "cache").string(), video, model, cv::Size(640, 640), 0.5f));
+    ASSERT_TRUE(cache.isRecording());
+    cache.record(0, {cv::Rect(50, 50, 10, 10), cv::Rect(1, 1, 5, 5)});
+    cache.record(1, {});
+    cache.markComplete(2);
+    cache.close();
+
+    ASSERT_TRUE(cache.open((dir / "cache").string(), video, model, cv::Size(640, 640), 0.5f));
+    std::vector<cv::Rect> detections;
+    ASSERT_TRUE(cache.lookup(0, detections));
+    ASSERT_EQUAL(detections.size(), 2u);
+    // Model output order is preserved
+    ASSERT_TRUE(detections[0] == cv::Rect(50, 50, 10, 10));
+    ASSERT_TRUE(cache.lookup(1, detections));
+    ASSERT_TRUE(detections.empty());
+    ASSERT_FALSE(cache.lookup(2, detections));
+    cache.close();
+
+    fs::remove_all(dir);
+}
+
+TEST(DetectionCacheDropsPartial) {
+    fs::path dir = makeCacheFixture();
+    std::string video = (dir / "video.mp4").string();
+    std::string model = (dir / "model.onnx").string();
+    DetectionCache& cache = DetectionCache::getInstance();
+
+    ASSERT_FALSE(cache.open((dir / "cache").string(), video, model, cv::Size(640, 640), 0.5f));
+    cache.record(0, {cv::Rect(1, 1, 5, 5)});
+    cache.close();  // Stopped before the end of the stream
+
+    ASSERT_FALSE(cache.open((dir / "cache").string(), video, model, cv::Size(640, 640), 0.5f));
+    cache.close();
+
+    fs::remove_all(dir);
+}
+
+TEST(DetectionCacheDropsTail) {
+    fs::path dir = makeCacheFixture();
+    std::string video = (dir / "video.mp4").string();
+    std::string model = (dir / "model.onnx").string();
+    DetectionCache& cache = DetectionCache::getInstance();
+
+    // The source delivered three frames but the pipeline stopped with the last one unrecorded
+    ASSERT_FALSE(cache.open((dir / "cache").string(), video, model, cv::Size(640, 640), 0.5f));
+    cache.record(0, {cv::Rect(1, 1, 5, 5)});
+    cache.record(1, {});
+    cache.markComplete(3);
+    cache.close();
+
+    ASSERT_FALSE(cache.open((dir / "cache").string(), video, model, cv::Size(640, 640), 0.5f));
+    ASSERT_TRUE(cache.isRecording());
+    cache.close();
+    ASSERT_TRUE(fs::is_empty(dir / "cache"));
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,83 @@
+#include "unit_test.h"
+#include "image_process.h"
+#include <cmath>
+
+TEST(TilesCoverFrame) {
+    cv::Size frame(3840, 2160);
+    std::vector<cv::Rect> tiles = ImageProcessor::computeTiles(frame, 640, 0.2);
+
+    // 8 columns and 4 rows give at least 128 px of overlap
+    ASSERT_EQUAL(tiles.size(), 32u);
+    ASSERT_TRUE(tiles.front() == cv::Rect(0, 0, 640, 640));
+    ASSERT_TRUE(tiles.back() == cv::Rect(3200, 1520, 640, 640));
+    for (size_t i = 1; i < 8; ++i) {
+        int overlap = tiles[i - 1].x + tiles[i - 1].width - tiles[i].x;
+        ASSERT_TRUE(overlap >= 128);
+    }
+}
+
+TEST(TilesSmallFrame) {
+    std::vector<cv::Rect> tiles = ImageProcessor::computeTiles(cv::Size(600, 400), 640, 0.2);
+    ASSERT_EQUAL(tiles.size(), 1u);
+    ASSERT_TRUE(tiles[0] == cv::Rect(0, 0, 600, 400));
+}
+
+TEST(LetterboxWideFrame) {
+    cv::Mat image(720, 1280, CV_8UC3, cv::Scalar(0, 0, 255));
+    InferenceRegion region{cv::Rect(0, 0, 1280, 720)};
+    cv::Mat boxed = ImageProcessor::letterbox(image, cv::Size(640, 640), region);
+
+    ASSERT_TRUE(boxed.size() == cv::Size(640, 640));
+    ASSERT_TRUE(std::abs(region.scaleX - 0.5f) < 1e-3f);
+    ASSERT_TRUE(std::abs(region.scaleY - 0.5f) < 1e-3f);
+    ASSERT_TRUE(std::abs(region.pad.y - 140.0f) < 1e-3f);
+
+    // Padding is gray, the image sits between the bands
+    ASSERT_EQUAL(boxed.at<cv::Vec3b>(10, 320)[0], 114);
+    ASSERT_EQUAL(boxed.at<cv::Vec3b>(320, 320)[2], 255);
+}
+
+TEST(LetterboxRectInput) {
+    // 16:9 into 640x384 fills the width, 360 rows plus 12 rows of padding each side
+    cv::Mat image(1080, 1920, CV_8UC3, cv::Scalar::all(0));
+    InferenceRegion region{cv::Rect(0, 0, 1920, 1080)};
+    ImageProcessor::letterbox(image, cv::Size(640, 384), region);
+
+    ASSERT_TRUE(std::abs(region.pad.x - 0.0f) < 1e-3f);
+    ASSERT_TRUE(std::abs(region.pad.y - 12.0f) < 1e-3f);
+
+    // A model input point maps back to the original pixel
+    float x = (332.0f - region.pad.x) / region.scaleX;
+    float y = (192.0f - region.pad.y) / region.scaleY;
+    ASSERT_TRUE(std::abs(x - 996.0f) < 1e-3f);
+    ASSERT_TRUE(std::abs(y - 540.0f) < 1e-3f);
+}
+
+TEST(TensorShapeChannelsLast) {
+    std::vector<int64_t> dims = {2, 3, 384, 640};
+    InputTensorFormat planar;
+    InputTensorFormat interleaved;
+    interleaved.nhwc = true;
+
+    ASSERT_TRUE(ImageProcessor::tensorShape(dims, planar) == dims);
+    ASSERT_TRUE(ImageProcessor::tensorShape(dims, interleaved) == std::vector<int64_t>({2, 384, 640, 3}));
+}
+
+TEST(Uint8ChannelsLastBatch) {
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::vector<cv::Mat> images = {cv::Mat(2, 4, CV_8UC3, cv::Scalar(10, 20, 30)),
+                                   cv::Mat(4, 8, CV_8UC3, cv::Scalar(1, 2, 3))};
+    InputTensorFormat format;
+    format.uint8 = true;
+    format.nhwc = true;
+
+    cv::Mat blob;
+    Ort::Value tensor = ImageProcessor::preprocessBatchForONNX(images, blob, memory_info, {1, 3, 2, 4}, format);
+
+    // One byte per channel, the images stacked in bands of rows, the second one resized
+    ASSERT_EQUAL(blob.total() * blob.elemSize(), 2u * 2 * 4 * 3);
+    ASSERT_TRUE(tensor.GetTensorTypeAndShapeInfo().GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8);
+    ASSERT_TRUE(tensor.GetTensorTypeAndShapeInfo().GetShape() == std::vector<int64_t>({2, 2, 4, 3}));
+    ASSERT_EQUAL(blob.at<cv::Vec3b>(1, 3)[2], 30);
+    ASSERT_EQUAL(blob.at<cv::Vec3b>(2, 0)[0], 1);
+}
@@ -168,4 +168,16 @@ TEST(DisablingAllLogs) {
     ASSERT_TRUE(output.empty());
 
     resetLogLevel();
-}
\ No newline at end of file
+}
+TEST(RedirectingLogOutput) {
+    std::stringstream redirected;
+    Logger::getInstance().setOutput(redirected);
+
+    std::string stdoutOutput = captureLogOutput([]() {
+        LOG_INFO("Redirected message");
+    });
+    Logger::getInstance().setOutput(std::cout);
+
+    ASSERT_TRUE(stdoutOutput.empty());
+    ASSERT_TRUE(redirected.str().find("INFO: Redirected message") != std::string::npos);
+}
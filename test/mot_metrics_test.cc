@@ -0,0 +1,68 @@
+#include "unit_test.h"
+#include "mot_metrics.h"
+#include "assignment.h"
+#include <cmath>
+
+TEST(AssignmentMinimizesCost) {
+    std::vector<std::vector<double>> cost = {
+        {4, 1, 3},
+        {2, 0, 5},
+        {3, 2, 2},
+    };
+    std::vector<int> result = solveAssignment(cost);
+    ASSERT_EQUAL(result[0], 1);
+    ASSERT_EQUAL(result[1], 0);
+    ASSERT_EQUAL(result[2], 2);
+}
+
+TEST(AssignmentSkipsInfeasiblePairs) {
+    std::vector<std::vector<double>> cost = {
+        {ASSIGNMENT_INFEASIBLE, ASSIGNMENT_INFEASIBLE},
+        {1, ASSIGNMENT_INFEASIBLE},
+        {0.5, 2},
+    };
+    std::vector<int> result = solveAssignment(cost);
+    ASSERT_EQUAL(result[0], -1);
+    ASSERT_EQUAL(result[1], 0);
+    ASSERT_EQUAL(result[2], 1);
+}
+
+TEST(MOTPerfectTracking) {
+    MOTEvaluator evaluator;
+    for (int f = 0; f < 10; ++f) {
+        std::vector<cv::Rect> boxes = {cv::Rect(10 + f, 10, 50, 50), cv::Rect(200, 100 + f, 40, 80)};
+        evaluator.addFrame(boxes, {1, 2}, boxes, {7, 9});
+    }
+
+    MOTMetrics metrics = evaluator.compute();
+    ASSERT_EQUAL(metrics.frames, 10);
+    ASSERT_EQUAL(metrics.idSwitches, 0);
+    ASSERT_EQUAL(metrics.falsePositives, 0);
+    ASSERT_EQUAL(metrics.falseNegatives, 0);
+    ASSERT_TRUE(std::abs(metrics.mota - 1.0) < 1e-9);
+    ASSERT_TRUE(std::abs(metrics.idf1 - 1.0) < 1e-9);
+}
+
+TEST(MOTCountsIdentitySwitch) {
+    MOTEvaluator evaluator;
+    cv::Rect box(100, 100, 50, 50);
+    for (int f = 0; f < 4; ++f) {
+        // The tracker changes the ID of the only object half way through
+        evaluator.addFrame({box}, {1}, {box}, {f < 2 ? 5 : 6});
+    }
+
+    MOTMetrics metrics = evaluator.compute();
+    ASSERT_EQUAL(metrics.idSwitches, 1);
+    ASSERT_TRUE(std::abs(metrics.mota - 0.75) < 1e-9);
+    ASSERT_TRUE(std::abs(metrics.idf1 - 0.5) < 1e-9);
+}
+
+TEST(MOTCountsMissesAndFPs) {
+    MOTEvaluator evaluator;
+    evaluator.addFrame({cv::Rect(0, 0, 10, 10)}, {1}, {cv::Rect(100, 100, 10, 10)}, {1});
+
+    MOTMetrics metrics = evaluator.compute();
+    ASSERT_EQUAL(metrics.falseNegatives, 1);
+    ASSERT_EQUAL(metrics.falsePositives, 1);
+    ASSERT_TRUE(std::abs(metrics.mota + 1.0) < 1e-9);
+}
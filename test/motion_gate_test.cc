@@ -0,0 +1,39 @@
+#include "unit_test.h"
+#include "motion_gate.h"
+#include <vector>
+
+TEST(SumAbsDiffMatchesScalar) {
+    std::vector<uint8_t> a(100), b(100);
+    uint64_t expected = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = static_cast<uint8_t>(i * 37);
+        b[i] = static_cast<uint8_t>(255 - i * 11);
+        expected += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+    }
+    // 100 bytes exercise both the vector loop and the scalar tail
+    ASSERT_EQUAL(MotionGate::sumAbsDiff(a.data(), b.data(), a.size()), expected);
+}
+
+TEST(MotionGateSkipsStaticFrames) {
+    MotionGate gate(160, 4.0, 0);
+    cv::Mat frame(360, 640, CV_8UC3, cv::Scalar(40, 40, 40));
+
+    ASSERT_TRUE(gate.shouldInfer(frame));
+    ASSERT_FALSE(gate.shouldInfer(frame));
+
+    // A small object appearing changes one block well past the threshold
+    cv::Mat moved = frame.clone();
+    cv::rectangle(moved, cv::Rect(300, 150, 40, 40), cv::Scalar(255, 255, 255), cv::FILLED);
+    ASSERT_TRUE(gate.shouldInfer(moved));
+    ASSERT_FALSE(gate.shouldInfer(moved));
+}
+
+TEST(MotionGateForcesRefresh) {
+    MotionGate gate(160, 4.0, 3);
+    cv::Mat frame(360, 640, CV_8UC3, cv::Scalar(40, 40, 40));
+
+    ASSERT_TRUE(gate.shouldInfer(frame));
+    ASSERT_FALSE(gate.shouldInfer(frame));
+    ASSERT_FALSE(gate.shouldInfer(frame));
+    ASSERT_TRUE(gate.shouldInfer(frame));
+}
@@ -0,0 +1,51 @@
+#include "unit_test.h"
+#include "pipeline.h"
+#include "work_stealing_pool.h"
+#include <chrono>
+#include <thread>
+
+TEST(PoolRunsNestedTasks) {
+    std::atomic<int> done{0};
+    {
+        WorkStealingPool pool(4);
+        for (int i = 0; i < 100; ++i) {
+            // Follow-up tasks land on the submitting worker's own deque
+            pool.submit([&pool, &done]() {
+                pool.submit([&done]() { done++; });
+                done++;
+            });
+        }
+        pool.stop();
+    }
+    ASSERT_EQUAL(done.load(), 200);
+}
+
+TEST(PipelineSerialStageOrder) {
+    ThreadSafeQueue<Frame> input;
+    ThreadSafeQueue<Frame> output;
+    std::vector<int64_t> serialOrder;
+
+    {
+        Pipeline pipeline(input, output, 4, 8);
+        pipeline.addStage("work", Pipeline::StageMode::PARALLEL, [](Frame& frame) {
+            // Early frames take longest, so they finish out of order
+            std::this_thread::sleep_for(std::chrono::microseconds(200 * (10 - frame.frameIndex % 10)));
+        });
+        pipeline.addStage("serial", Pipeline::StageMode::SERIAL, [&serialOrder](Frame& frame) {
+            serialOrder.push_back(frame.frameIndex);
+        });
+
+        for (int64_t i = 0; i < 40; ++i) {
+            Frame frame;
+            frame.frameIndex = i;
+            pipeline.submit(std::move(frame));
+        }
+        pipeline.finish();
+    }
+
+    ASSERT_EQUAL(serialOrder.size(), 40u);
+    ASSERT_EQUAL(output.size(), 40u);
+    for (int64_t i = 0; i < 40; ++i) {
+        ASSERT_EQUAL(serialOrder[i], i);
+    }
+}
@@ -0,0 +1,83 @@
+#include "unit_test.h"
+#include "quality_controller.h"
+
+namespace {
+
+QualityController::Options testOptions() {
+    QualityController::Options options;
+    options.targetFPS = 20.0;
+    options.margin = 0.1;
+    options.windows = 2;
+    options.maxDetectionInterval = 3;
+    options.minInputScale = 0.5;
+    options.maxTileScale = 1.0;
+    options.inputSize = cv::Size(640, 640);
+    options.resizableInput = true;
+    return options;
+}
+
+} // namespace
+
+TEST(QualityLadderCyclesKnobs) {
+    std::vector<QualityController::Settings> ladder = QualityController::buildLadder(testOptions());
+
+    // Interval 2, 512 px, interval 3, 416 px, 320 px
+    ASSERT_EQUAL(ladder.size(), 6u);
+    ASSERT_EQUAL(ladder[0].detectionInterval, 1);
+    ASSERT_TRUE(ladder[0].inputSize == cv::Size(640, 640));
+    ASSERT_EQUAL(ladder[1].detectionInterval, 2);
+    ASSERT_TRUE(ladder[2].inputSize == cv::Size(512, 512));
+    ASSERT_EQUAL(ladder[3].detectionInterval, 3);
+    ASSERT_TRUE(ladder[5].inputSize == cv::Size(320, 320));
+    ASSERT_EQUAL(ladder[5].detectionInterval, 3);
+}
+
+TEST(QualityLadderFixedInput) {
+    QualityController::Options options = testOptions();
+    options.resizableInput = false;
+    options.tileSize = 640;
+    options.maxTileScale = 2.0;
+    std::vector<QualityController::Settings> ladder = QualityController::buildLadder(options);
+
+    for (const auto& settings : ladder) {
+        ASSERT_TRUE(settings.inputSize == cv::Size(640, 640));
+    }
+    ASSERT_EQUAL(ladder.back().tileSize, 1248);
+}
+
+TEST(QualityHysteresis) {
+    QualityController& quality = QualityController::getInstance();
+    quality.configure(testOptions());
+
+    QualityController::Measurement slow;
+    slow.fps = 12.0;
+    slow.stageMs = 80.0;
+    QualityController::Measurement idle;
+    idle.fps = 20.0;
+    idle.stageMs = 10.0;
+
+    // One bad window is not enough
+    ASSERT_FALSE(quality.update(slow));
+    ASSERT_FALSE(quality.update(idle));
+    ASSERT_FALSE(quality.update(slow));
+    ASSERT_TRUE(quality.update(slow));
+    ASSERT_EQUAL(quality.getLevel(), 1);
+    ASSERT_EQUAL(quality.current().detectionInterval, 2);
+
+    // Hold after the change, then twice the windows of headroom to recover
+    ASSERT_FALSE(quality.update(slow));
+    ASSERT_FALSE(quality.update(slow));
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_FALSE(quality.update(idle));
+    }
+    ASSERT_TRUE(quality.update(idle));
+    ASSERT_EQUAL(quality.getLevel(), 0);
+
+    // A slow source is not the pipeline's fault
+    QualityController::Measurement starved;
+    starved.fps = 10.0;
+    starved.stageMs = 10.0;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_FALSE(quality.update(starved));
+    }
+}
@@ -0,0 +1,136 @@
+#include "unit_test.h"
+#include "reid_model.h"
+#include "tracker.h"
+#include <cmath>
+
+namespace {
+
+// Stands in for the ReID model: objects are told apart by box width
+std::vector<std::vector<float>> embedByWidth(const cv::Mat&, const std::vector<cv::Rect>& boxes) {
+    std::vector<std::vector<float>> embeddings;
+    for (const cv::Rect& box : boxes) {
+        std::vector<float> embedding(3, 0.0f);
+        embedding[(box.width / 10 - 4) % 3] = 1.0f;
+        embeddings.push_back(embedding);
+    }
+    return embeddings;
+}
+
+// Run one frame of detections through the tracker and return their track IDs
+std::vector<int> trackFrame(Tracker& tracker, int64_t index, const std::vector<cv::Rect>& detections) {
+    Frame frame;
+    frame.frameIndex = index;
+    frame.detections = detections;
+    tracker.updateTracks(frame);
+    return frame.trackIDs;
+}
+
+} // namespace
+
+TEST(GalleryKeepsClosestMatch) {
+    EmbeddingGallery gallery(4);
+    ASSERT_TRUE(gallery.empty());
+    ASSERT_TRUE(std::abs(gallery.distance({1.0f, 0.0f}) - 2.0f) < 1e-6f);
+
+    gallery.add({1.0f, 0.0f});
+    gallery.add({0.0f, 1.0f});
+    ASSERT_TRUE(gallery.distance({0.0f, 1.0f}) < 1e-6f);
+    ASSERT_TRUE(std::abs(gallery.distance({-1.0f, 0.0f}) - 1.0f) < 1e-6f);
+}
+
+TEST(GalleryReplacesOldest) {
+    EmbeddingGallery gallery(2);
+    gallery.add({1.0f, 0.0f});
+    gallery.add({0.0f, 1.0f});
+    gallery.add({-1.0f, 0.0f});
+
+    // The first embedding was overwritten, the other two remain
+    ASSERT_EQUAL(gallery.size(), 2u);
+    ASSERT_TRUE(std::abs(gallery.distance({1.0f, 0.0f}) - 1.0f) < 1e-6f);
+    ASSERT_TRUE(gallery.distance({-1.0f, 0.0f}) < 1e-6f);
+}
+
+TEST(CosineDistanceMismatch) {
+    ASSERT_TRUE(std::abs(EmbeddingGallery::cosineDistance({1.0f, 0.0f}, {1.0f}) - 2.0f) < 1e-6f);
+    ASSERT_TRUE(std::abs(EmbeddingGallery::cosineDistance({0.6f, 0.8f}, {0.8f, 0.6f}) - 0.04f) < 1e-5f);
+}
+
+TEST(ReIDReacquiresLostTrack) {
+    ThreadSafeQueue<Frame> input;
+    ThreadSafeQueue<Frame> output;
+    Tracker tracker(input, output);
+    tracker.setEmbedder(embedByWidth);
+
+    const cv::Rect a(100, 100, 40, 80);
+    const cv::Rect b(400, 100, 50, 80);
+    trackFrame(tracker, 0, {a, b});
+    std::vector<int> ids = trackFrame(tracker, 1, {a, b});
+    trackFrame(tracker, 2, {b});
+    trackFrame(tracker, 3, {b});
+
+    // Back after two missed frames, beside where it was lost and too far to overlap
+    std::vector<int> back = trackFrame(tracker, 4, {cv::Rect(130, 100, 40, 80), b});
+    ASSERT_EQUAL(back[0], ids[0]);
+    ASSERT_EQUAL(back[1], ids[1]);
+}
+
+TEST(ReIDIgnoresFarLookalike) {
+    ThreadSafeQueue<Frame> input;
+    ThreadSafeQueue<Frame> output;
+    Tracker tracker(input, output);
+    tracker.setEmbedder(embedByWidth);
+
+    const cv::Rect a(100, 100, 40, 80);
+    const cv::Rect b(400, 100, 50, 80);
+    trackFrame(tracker, 0, {a, b});
+    std::vector<int> ids = trackFrame(tracker, 1, {a, b});
+    trackFrame(tracker, 2, {b});
+
+    // Looks like the lost track but is further than it can have moved in one frame
+    std::vector<int> far = trackFrame(tracker, 3, {cv::Rect(500, 400, 40, 80), b});
+    ASSERT_TRUE(far[0] != ids[0]);
+    ASSERT_EQUAL(far[1], ids[1]);
+}
+
+TEST(ReIDKeepsLiveTracksByOverlap) {
+    ThreadSafeQueue<Frame> input;
+    ThreadSafeQueue<Frame> output;
+    Tracker tracker(input, output);
+    tracker.setEmbedder(embedByWidth);
+
+    const cv::Rect a(100, 100, 40, 80);
+    const cv::Rect b(400, 100, 50, 80);
+    const cv::Rect c(700, 100, 60, 80);
+    trackFrame(tracker, 0, {a, b, c});
+    std::vector<int> ids = trackFrame(tracker, 1, {a, b, c});
+    trackFrame(tracker, 2, {a, b});
+
+    // With c lost, a lookalike of a that does not overlap it must not take a's ID:
+    // a was seen on the previous frame, so only an overlapping detection continues it
+    std::vector<int> jumped = trackFrame(tracker, 3, {cv::Rect(100, 220, 40, 80), b});
+    ASSERT_TRUE(jumped[0] != ids[0]);
+    ASSERT_TRUE(jumped[0] != ids[2]);
+    ASSERT_EQUAL(jumped[1], ids[1]);
+}
+
+TEST(ReIDShortEmbedderUsesIoU) {
+    ThreadSafeQueue<Frame> input;
+    ThreadSafeQueue<Frame> output;
+    Tracker tracker(input, output);
+    tracker.setEmbedder(embedByWidth);
+
+    const cv::Rect a(100, 100, 40, 80);
+    const cv::Rect b(400, 100, 50, 80);
+    trackFrame(tracker, 0, {a, b});
+    std::vector<int> ids = trackFrame(tracker, 1, {a, b});
+    trackFrame(tracker, 2, {b});
+
+    // An embedder returning fewer rows than boxes: nothing is read past its result,
+    // the overlapping detection keeps its track and the lost one is not re-acquired
+    tracker.setEmbedder([](const cv::Mat&, const std::vector<cv::Rect>&) {
+        return std::vector<std::vector<float>>();
+    });
+    std::vector<int> next = trackFrame(tracker, 3, {cv::Rect(130, 100, 40, 80), cv::Rect(402, 100, 50, 80)});
+    ASSERT_TRUE(next[0] != ids[0]);
+    ASSERT_EQUAL(next[1], ids[1]);
+}
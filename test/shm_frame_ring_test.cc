@@ -0,0 +1,66 @@
+#include "unit_test.h"
+#include "shm_frame_ring.h"
+#include "shm_frame_source.h"
+#include <cstring>
+#include <unistd.h>
+
+static std::string testRingName(const char* name) {
+    return "/object-tracking-test-" + std::to_string(getpid()) + "-" + name;
+}
+
+TEST(ShmRingHandsOverInOrder) {
+    std::string name = testRingName("order");
+    std::unique_ptr<ShmFrameRing> producer = ShmFrameRing::create(name, 2, 64, 30.0);
+    ASSERT_TRUE(producer != nullptr);
+    std::unique_ptr<ShmFrameRing> consumer = ShmFrameRing::attach(name);
+    ASSERT_TRUE(consumer != nullptr);
+    ASSERT_EQUAL(consumer->slotCount(), 2u);
+
+    for (int i = 0; i < 2; ++i) {
+        int slot = producer->beginWrite(std::chrono::milliseconds(0));
+        ASSERT_TRUE(slot >= 0);
+        producer->publish(slot, 8, 8, ShmPixelFormat::GRAY, 8, 0);
+    }
+    // Both slots wait for the consumer, so a live producer has to drop
+    ASSERT_EQUAL(producer->beginWrite(std::chrono::milliseconds(0)), -1);
+
+    int first = consumer->acquire(std::chrono::milliseconds(100));
+    ASSERT_TRUE(first >= 0);
+    ASSERT_EQUAL(consumer->slot(first).sequence, 1u);
+    consumer->release(first);
+    ASSERT_TRUE(producer->beginWrite(std::chrono::milliseconds(0)) >= 0);
+
+    int second = consumer->acquire(std::chrono::milliseconds(100));
+    ASSERT_EQUAL(consumer->slot(second).sequence, 2u);
+    consumer->release(second);
+
+    producer->close();
+    ASSERT_EQUAL(consumer->acquire(std::chrono::milliseconds(1000)), -1);
+    ASSERT_TRUE(consumer->isClosed());
+}
+
+TEST(ShmSourceLeasesBgrSlots) {
+    std::string name = testRingName("lease");
+    std::unique_ptr<ShmFrameRing> producer = ShmFrameRing::create(name, 1, 4 * 2 * 3, 25.0);
+    ASSERT_TRUE(producer != nullptr);
+    int slot = producer->beginWrite(std::chrono::milliseconds(0));
+    std::memset(producer->data(slot), 7, 4 * 2 * 3);
+    producer->publish(slot, 4, 2, ShmPixelFormat::BGR, 4 * 3, 0);
+
+    ShmFrameSource source(name, std::chrono::milliseconds(200));
+    ASSERT_TRUE(source.open());
+    ASSERT_EQUAL(source.getFrameRate(), 25.0);
+    {
+        Frame frame;
+        ASSERT_TRUE(source.getNextFrame(frame));
+        ASSERT_EQUAL(frame.original.cols, 4);
+        ASSERT_EQUAL(frame.original.rows, 2);
+        ASSERT_EQUAL(frame.original.ptr(1)[11], 7);
+
+        // Pixels are read in place, so the slot stays with the consumer while the frame lives
+        producer->data(slot)[4 * 3 + 11] = 9;
+        ASSERT_EQUAL(frame.original.ptr(1)[11], 9);
+        ASSERT_EQUAL(producer->beginWrite(std::chrono::milliseconds(0)), -1);
+    }
+    ASSERT_EQUAL(producer->beginWrite(std::chrono::milliseconds(0)), slot);
+}
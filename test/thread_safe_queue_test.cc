@@ -0,0 +1,94 @@
+#include "unit_test.h"
+#include "thread_safe_queue.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(QueueCloseWakesConsumer) {
+    ThreadSafeQueue<int> queue;
+    std::atomic<bool> popped{true};
+    std::thread consumer([&] {
+        int item;
+        popped = queue.pop(item);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+    consumer.join();
+
+    ASSERT_FALSE(popped.load());
+    ASSERT_FALSE(queue.push(1));
+    ASSERT_TRUE(queue.is_closed());
+}
+
+TEST(QueueCloseKeepsItems) {
+    ThreadSafeQueue<int> queue;
+    queue.push(7);
+    queue.close();
+
+    int item = 0;
+    ASSERT_TRUE(queue.pop(item));
+    ASSERT_EQUAL(item, 7);
+    ASSERT_FALSE(queue.pop(item));
+}
+
+TEST(QueuePopForTimesOut) {
+    ThreadSafeQueue<int> queue;
+    int item = 0;
+    ASSERT_FALSE(queue.pop_for(item, std::chrono::milliseconds(5)));
+    ASSERT_FALSE(queue.try_pop(item));
+
+    queue.push(3);
+    ASSERT_TRUE(queue.pop_for(item, std::chrono::milliseconds(5)));
+    ASSERT_EQUAL(item, 3);
+}
+
+TEST(QueueBulkRoundTrip) {
+    ThreadSafeQueue<int> queue;
+    std::vector<int> items = {1, 2, 3, 4, 5};
+    ASSERT_EQUAL(queue.push_bulk(items), 5u);
+    ASSERT_TRUE(items.empty());
+
+    std::vector<int> batch;
+    ASSERT_EQUAL(queue.drain(batch, 3), 3u);
+    ASSERT_EQUAL(batch[0], 1);
+    ASSERT_EQUAL(batch[2], 3);
+    ASSERT_EQUAL(queue.drain(batch, 10), 2u);
+    ASSERT_EQUAL(batch.back(), 5);
+
+    queue.close();
+    ASSERT_EQUAL(queue.drain(batch, 10), 0u);
+}
+
+TEST(QueueBulkBlocksWhenFull) {
+    ThreadSafeQueue<int> queue(2);
+    std::thread producer([&] {
+        std::vector<int> items = {1, 2, 3, 4, 5, 6};
+        queue.push_bulk(items);
+        queue.close();
+    });
+
+    std::vector<int> received;
+    std::vector<int> batch;
+    while (queue.drain(batch, 4) > 0) {
+        ASSERT_TRUE(queue.size() <= 2u);
+        received.insert(received.end(), batch.begin(), batch.end());
+        batch.clear();
+    }
+    producer.join();
+
+    ASSERT_EQUAL(received.size(), 6u);
+    ASSERT_EQUAL(received[5], 6);
+}
+
+TEST(QueueBulkDropsOldest) {
+    ThreadSafeQueue<int> queue(2, QueueOverflowPolicy::DROP_OLDEST);
+    std::vector<int> items = {1, 2, 3};
+    ASSERT_EQUAL(queue.push_bulk(items), 3u);
+    ASSERT_EQUAL(queue.dropped(), 1u);
+
+    int item = 0;
+    ASSERT_TRUE(queue.try_pop(item));
+    ASSERT_EQUAL(item, 2);
+}
@@ -0,0 +1,98 @@
+#include "unit_test.h"
+#include "track_log.h"
+#include "display.h"
+#include <cstdio>
+#include <filesystem>
+
+static std::string tempLogPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(TrackLogRoundTrip) {
+    std::string path = tempLogPath("track_log_roundtrip.trk");
+    {
+        TrackLogWriter writer(path);
+        ASSERT_TRUE(writer.isOpen());
+        writer.append(0, {cv::Rect(10, 20, 30, 40), cv::Rect(5, 6, 7, 8)}, {9, 3});
+        writer.append(1, {}, {});
+        // Gap larger than a 16-bit delta needs escape records
+        writer.append(2, {cv::Rect(1, 2, 3, 4), cv::Rect(-5, 0, 10, 10)}, {1, 200000});
+    }
+
+    TrackLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_TRUE(reader.isComplete());
+    ASSERT_EQUAL(reader.frameCount(), 3u);
+
+    std::vector<cv::Rect> boxes;
+    std::vector<int> ids;
+    TrackLogReader::decode(reader.frame(0), boxes, ids);
+    ASSERT_EQUAL(ids.size(), 2u);
+    ASSERT_EQUAL(ids[0], 3);
+    ASSERT_TRUE(boxes[0] == cv::Rect(5, 6, 7, 8));
+    ASSERT_EQUAL(ids[1], 9);
+    ASSERT_TRUE(boxes[1] == cv::Rect(10, 20, 30, 40));
+
+    TrackLogReader::decode(reader.frame(1), boxes, ids);
+    ASSERT_TRUE(ids.empty());
+
+    ASSERT_EQUAL(reader.findFrame(2), 2);
+    ASSERT_EQUAL(reader.findFrame(7), -1);
+    TrackLogReader::decode(reader.frame(2), boxes, ids);
+    ASSERT_EQUAL(ids.size(), 2u);
+    ASSERT_EQUAL(ids[1], 200000);
+    ASSERT_TRUE(boxes[1] == cv::Rect(-5, 0, 10, 10));
+
+    std::remove(path.c_str());
+}
+
+TEST(TrackLogScansUnclosedLog) {
+    std::string path = tempLogPath("track_log_unclosed.trk");
+    {
+        TrackLogWriter writer(path);
+        writer.append(4, {cv::Rect(1, 1, 2, 2)}, {1});
+        writer.append(5, {cv::Rect(2, 2, 2, 2)}, {1});
+    }
+
+    // Drop the index table and footer as if the writer had been killed
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) -
+                                       2 * sizeof(TrackLogIndexEntry) - sizeof(TrackLogFooter));
+
+    TrackLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_FALSE(reader.isComplete());
+    ASSERT_EQUAL(reader.frameCount(), 2u);
+    ASSERT_EQUAL(reader.findFrame(5), 1);
+
+    std::remove(path.c_str());
+}
+
+TEST(TrackReplayRendersLog) {
+    std::string path = tempLogPath("track_log_replay.trk");
+    {
+        TrackLogWriter writer(path);
+        writer.append(0, {cv::Rect(200, 150, 40, 40)}, {7});
+        writer.append(2, {cv::Rect(20, 150, 40, 40)}, {7});
+    }
+
+    TrackLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+
+    // Frames as a FrameSource delivers them: only the original image is set
+    size_t logged = 0;
+    for (int64_t index = 0; index < 3; ++index) {
+        Frame frame;
+        frame.original = cv::Mat(240, 320, CV_8UC3, cv::Scalar::all(0));
+        frame.frameIndex = index;
+        if (Display::loadLoggedTracks(frame, reader)) logged++;
+
+        cv::Mat annotated = Display::renderFrame(frame, true, 30.0);
+        ASSERT_TRUE(annotated.size() == frame.original.size());
+        ASSERT_EQUAL(frame.detections.size(), frame.trackIDs.size());
+        cv::Vec3b edge = annotated.at<cv::Vec3b>(170, 200);
+        ASSERT_EQUAL(edge[1], index == 0 ? 255 : 0);
+    }
+    ASSERT_EQUAL(logged, 2u);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,90 @@
+#include "unit_test.h"
+#include "track_results.h"
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+static std::string testResultsName(const char* name) {
+    return "/object-tracking-results-test-" + std::to_string(getpid()) + "-" + name;
+}
+
+TEST(TrackResultsRoundTrip) {
+    std::string name = testResultsName("roundtrip");
+    std::unique_ptr<TrackResultsWriter> writer = TrackResultsWriter::create(name, 4, 2);
+    ASSERT_TRUE(writer != nullptr);
+    std::unique_ptr<TrackResultsReader> reader = TrackResultsReader::attach(name);
+    ASSERT_TRUE(reader != nullptr);
+
+    TrackResultsFrame frame;
+    ASSERT_FALSE(reader->readLatest(frame));
+
+    TrackRecord tracks[3] = {{1, 10, 20, 30, 40, 0.9f}, {2, 0, 0, 5, 5, 0.5f}, {3, 1, 1, 1, 1, 0.1f}};
+    writer->publish(7, 1000, 640, 480, tracks, 1);
+    writer->publish(8, 2000, 640, 480, tracks, 3);
+
+    ASSERT_TRUE(reader->readLatest(frame));
+    ASSERT_EQUAL(frame.sequence, 2u);
+    ASSERT_EQUAL(frame.frameIndex, 8);
+    ASSERT_EQUAL(frame.frameWidth, 640u);
+    // Only two tracks fit a slot
+    ASSERT_EQUAL(frame.tracks.size(), 2u);
+    ASSERT_EQUAL(frame.tracks[1].trackId, 2);
+
+    ASSERT_TRUE(reader->read(1, frame));
+    ASSERT_EQUAL(frame.captureTimeNs, 1000);
+    ASSERT_EQUAL(frame.tracks.size(), 1u);
+    ASSERT_EQUAL(frame.tracks[0].height, 40);
+    ASSERT_FALSE(reader->read(3, frame));
+}
+
+TEST(TrackResultsOverwritten) {
+    std::string name = testResultsName("overwrite");
+    std::unique_ptr<TrackResultsWriter> writer = TrackResultsWriter::create(name, 2, 1);
+    std::unique_ptr<TrackResultsReader> reader = TrackResultsReader::attach(name);
+    ASSERT_TRUE(reader != nullptr);
+
+    for (int i = 0; i < 3; ++i) {
+        writer->publish(i, 0, 16, 16, nullptr, 0);
+    }
+    // The third frame took the first frame's slot
+    TrackResultsFrame frame;
+    ASSERT_FALSE(reader->read(1, frame));
+    ASSERT_TRUE(reader->read(2, frame));
+    ASSERT_EQUAL(reader->latest(), 3u);
+
+    writer.reset();
+    ASSERT_TRUE(reader->isClosed());
+}
+
+TEST(TrackResultsNeverTorn) {
+    std::string name = testResultsName("torn");
+    std::unique_ptr<TrackResultsWriter> writer = TrackResultsWriter::create(name, 2, 8);
+    std::unique_ptr<TrackResultsReader> reader = TrackResultsReader::attach(name);
+    ASSERT_TRUE(reader != nullptr);
+
+    // Every record of frame n carries n, and frame n has n % 8 + 1 records
+    std::atomic<bool> done(false);
+    std::thread publisher([&]() {
+        TrackRecord tracks[8];
+        for (int n = 1; n <= 20000; ++n) {
+            for (TrackRecord& track : tracks) {
+                track = {n, n, n, n, n, 0.0f};
+            }
+            writer->publish(n, 0, 0, 0, tracks, static_cast<size_t>(n % 8 + 1));
+        }
+        done = true;
+    });
+
+    bool consistent = true;
+    TrackResultsFrame frame;
+    while (!done) {
+        if (!reader->readLatest(frame)) continue;
+        consistent = consistent && frame.tracks.size() == frame.sequence % 8 + 1;
+        for (const TrackRecord& track : frame.tracks) {
+            consistent = consistent && track.trackId == static_cast<int32_t>(frame.sequence) &&
+                         track.height == track.trackId;
+        }
+    }
+    publisher.join();
+    ASSERT_TRUE(consistent);
+}
@@ -0,0 +1,83 @@
+#include "unit_test.h"
+#include "tracker.h"
+
+// Pipeline counters the tracker reports to, defined by main() in the application
+std::atomic<bool> shouldExit(false);
+std::atomic<long long> totalTrackerTime(0);
+std::atomic<long long> totalInferenceTime(0);
+std::atomic<bool> fullFrameScanRequested(false);
+
+namespace {
+
+TrajectoryPoint pointAt(int64_t frame, const cv::Rect& box) {
+    TrajectoryPoint point;
+    point.box = box;
+    point.frameIndex = frame;
+    return point;
+}
+
+} // namespace
+
+TEST(TrackCropsPadAndMerge) {
+    std::vector<cv::Rect> boxes = {cv::Rect(100, 100, 20, 20), cv::Rect(130, 100, 20, 20),
+                                   cv::Rect(800, 800, 20, 20)};
+    std::vector<cv::Rect> crops = Tracker::planTrackCrops(boxes, cv::Size(1000, 1000), 0.5, 0);
+
+    // Half a box of padding per side; the two close crops overlap and become one
+    ASSERT_EQUAL(crops.size(), 2u);
+    ASSERT_TRUE(crops[0] == cv::Rect(90, 90, 70, 40));
+    ASSERT_TRUE(crops[1] == cv::Rect(790, 790, 40, 40));
+}
+
+TEST(TrackCropsStayInFrame) {
+    std::vector<cv::Rect> crops = Tracker::planTrackCrops({cv::Rect(0, 0, 10, 10), cv::Rect(630, 470, 10, 10)},
+                                                          cv::Size(640, 480), 0.2, 64);
+    ASSERT_EQUAL(crops.size(), 2u);
+    ASSERT_TRUE(crops[0] == cv::Rect(0, 0, 64, 64));
+    ASSERT_TRUE(crops[1] == cv::Rect(576, 416, 64, 64));
+}
+
+TEST(TrackCropsFallBackToFull) {
+    // Nothing to look around
+    ASSERT_TRUE(Tracker::planTrackCrops({}, cv::Size(640, 480), 0.2, 64).empty());
+    // Crops covering half the frame cost as much as scanning it whole
+    ASSERT_TRUE(Tracker::planTrackCrops({cv::Rect(0, 0, 400, 400)}, cv::Size(640, 480), 0.0, 64).empty());
+    ASSERT_EQUAL(Tracker::planTrackCrops({cv::Rect(0, 0, 300, 300)}, cv::Size(640, 480), 0.0, 64).size(), 1u);
+}
+
+TEST(PredictBoxConstantVelocity) {
+    TrajectoryArena arena(4);
+    int slot = arena.acquire();
+    ASSERT_TRUE(Tracker::predictBox(arena.view(slot), 5).area() == 0);
+
+    arena.append(slot, pointAt(10, cv::Rect(100, 100, 20, 20)));
+    ASSERT_TRUE(Tracker::predictBox(arena.view(slot), 11) == cv::Rect(100, 100, 20, 20));
+
+    // 20 px right over two frames continues at 10 px per frame
+    arena.append(slot, pointAt(12, cv::Rect(120, 96, 20, 20)));
+    ASSERT_TRUE(Tracker::predictBox(arena.view(slot), 13) == cv::Rect(130, 94, 20, 20));
+    ASSERT_TRUE(Tracker::predictBox(arena.view(slot), 16) == cv::Rect(160, 88, 20, 20));
+    // Frames not after the newest point keep the observed box
+    ASSERT_TRUE(Tracker::predictBox(arena.view(slot), 12) == cv::Rect(120, 96, 20, 20));
+}
+
+TEST(TrackerFlagsMissedTracks) {
+    ThreadSafeQueue<Frame> input;
+    ThreadSafeQueue<Frame> output;
+    Tracker tracker(input, output);
+    ASSERT_FALSE(tracker.hasMissedTracks());
+
+    Frame first;
+    first.frameIndex = 0;
+    first.detections = {cv::Rect(10, 10, 40, 40), cv::Rect(200, 200, 40, 40)};
+    tracker.updateTracks(first);
+    ASSERT_FALSE(tracker.hasMissedTracks());
+
+    // One track left its crop and was not detected: the next frame needs a full scan
+    Frame second;
+    second.frameIndex = 1;
+    second.detections = {cv::Rect(12, 10, 40, 40)};
+    tracker.updateTracks(second);
+    ASSERT_EQUAL(second.trackIDs[0], first.trackIDs[0]);
+    ASSERT_TRUE(tracker.hasMissedTracks());
+}
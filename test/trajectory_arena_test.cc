@@ -0,0 +1,55 @@
+#include "unit_test.h"
+#include "trajectory_arena.h"
+
+namespace {
+
+TrajectoryPoint pointAt(int frame) {
+    TrajectoryPoint point;
+    point.box = cv::Rect(frame, 0, 10, 10);
+    point.frameIndex = frame;
+    point.score = 0.5f;
+    return point;
+}
+
+} // namespace
+
+TEST(TrajectoryRingOverwrites) {
+    TrajectoryArena arena(3, 4);
+    int slot = arena.acquire();
+    ASSERT_TRUE(arena.view(slot).empty());
+
+    for (int frame = 0; frame < 5; ++frame) {
+        arena.append(slot, pointAt(frame));
+    }
+
+    // Only the last three states remain, oldest first
+    TrajectoryView view = arena.view(slot);
+    ASSERT_EQUAL(view.size(), 3u);
+    ASSERT_EQUAL(view[0].frameIndex, 2);
+    ASSERT_EQUAL(view[1].frameIndex, 3);
+    ASSERT_EQUAL(view.back().frameIndex, 4);
+}
+
+TEST(TrajectorySlotsAreReused) {
+    TrajectoryArena arena(8, 2);
+    int first = arena.acquire();
+    int second = arena.acquire();
+    ASSERT_EQUAL(arena.capacity(), 2u);
+
+    arena.append(first, pointAt(1));
+    arena.release(first);
+    int reused = arena.acquire();
+
+    // The released slot comes back empty and no slab was added
+    ASSERT_EQUAL(reused, first);
+    ASSERT_TRUE(arena.view(reused).empty());
+    ASSERT_EQUAL(arena.capacity(), 2u);
+    ASSERT_EQUAL(arena.live(), 2u);
+
+    // A third live trajectory needs a new slab; existing views stay put
+    arena.append(second, pointAt(7));
+    const TrajectoryPoint* before = &arena.view(second)[0];
+    arena.acquire();
+    ASSERT_EQUAL(arena.capacity(), 4u);
+    ASSERT_TRUE(&arena.view(second)[0] == before);
+}
@@ -0,0 +1,298 @@
+/**
+ * @file mot_eval.cc
+ * @brief Evaluate the tracker on a MOTChallenge sequence
+ *
+ * Reads a sequence laid out as in the MOTChallenge benchmark (seqinfo.ini,
+ * img1/, det/det.txt, gt/gt.txt), runs Tracker::updateTracks frame by frame
+ * and reports MOTA, IDF1, ID switches and the per-frame tracker latency.
+ *
+ * Usage: mot-eval <config.ini> <sequence_dir> [options]
+ *   --detector replay|model   Where detections come from (default: replay)
+ *   --detections <file>       Detections to replay (default: <sequence_dir>/det/det.txt)
+ *   --min-score <value>       Skip replayed detections scoring below this value
+ *   --save-detections <file>  Write the detections accepted by the model in det.txt format
+ *   --output <file>           Write the tracker output in MOTChallenge format
+ *   --json <file>             Write the summary as JSON (stdout if omitted)
+ */
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "logger.h"
+#include "frame.h"
+#include "image_process.h"
+#include "onnx_model.h"
+#include "reid_model.h"
+#include "tracker.h"
+#include "thread_safe_queue.h"
+#include "mot_metrics.h"
+#include "benchmark.h"
+
+namespace fs = std::filesystem;
+
+// Pipeline globals normally defined in main.cc, referenced by the tracker
+std::atomic<bool> shouldExit(false);
+std::atomic<bool> fullFrameScanRequested(false);
+std::atomic<long long> totalTrackerTime(0);
+std::atomic<long long> totalInferenceTime(0);
+
+struct MOTBox {
+    int id;
+    cv::Rect box;
+    float score;
+};
+
+typedef std::map<int, std::vector<MOTBox>> MOTSequence;  // Frame number (1-based) -> boxes
+
+/**
+ * @brief Read a MOTChallenge CSV file (det.txt or gt.txt)
+ * @param isGroundTruth Apply the ground truth "consider" flag and class filter
+ */
+static bool readMOTFile(const fs::path& path, bool isGroundTruth, float minScore, MOTSequence& sequence) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open %s", path.string().c_str());
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::vector<double> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            fields.push_back(field.empty() ? 0.0 : std::stod(field));
+        }
+        if (fields.size() < 6) continue;
+
+        float score = fields.size() > 6 ? static_cast<float>(fields[6]) : 1.0f;
+        if (isGroundTruth) {
+            // Column 7 is the "consider" flag, column 8 the class (1 = pedestrian, -1 = unspecified)
+            if (score == 0.0f) continue;
+            if (fields.size() > 7 && fields[7] != 1 && fields[7] != -1) continue;
+        } else if (score < minScore) {
+            continue;
+        }
+
+        // MOTChallenge coordinates are 1-based
+        cv::Rect box(cvRound(fields[2]) - 1, cvRound(fields[3]) - 1, cvRound(fields[4]), cvRound(fields[5]));
+        sequence[static_cast<int>(fields[0])].push_back({static_cast<int>(fields[1]), box, score});
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write one frame of boxes in MOTChallenge format
+ */
+static void writeMOTLines(std::ofstream& out, int frameNumber, const std::vector<cv::Rect>& boxes,
+                          const std::vector<int>& ids) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const cv::Rect& box = boxes[i];
+        out << frameNumber << "," << (ids.empty() ? -1 : ids[i]) << ","
+            << box.x + 1 << "," << box.y + 1 << "," << box.width << "," << box.height
+            << ",1,-1,-1,-1\n";
+    }
+}
+
+/**
+ * @brief Read the [Sequence] section of seqinfo.ini
+ */
+static std::map<std::string, std::string> readSeqInfo(const fs::path& path) {
+    std::map<std::string, std::string> info;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t pos = line.find('=');
+        if (pos == std::string::npos) continue;
+        std::string key = line.substr(0, pos);
+        std::string value = line.substr(pos + 1);
+        key.erase(key.find_last_not_of(" \t\r") + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r") + 1);
+        info[key] = value;
+    }
+    return info;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        LOG_ERROR("Usage: %s <config.ini> <sequence_dir> [--detector replay|model] [--detections <file>] "
+                  "[--min-score <value>] [--save-detections <file>] [--output <file>] [--json <file>]", argv[0]);
+        return 1;
+    }
+
+    std::string configPath = argv[1];
+    fs::path sequenceDir = argv[2];
+    std::string detector = "replay";
+    fs::path detectionsPath = sequenceDir / "det" / "det.txt";
+    float minScore = -std::numeric_limits<float>::infinity();
+    std::string saveDetectionsPath, outputPath, jsonPath;
+
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--detector") detector = value;
+        else if (arg == "--detections") detectionsPath = value;
+        else if (arg == "--min-score") minScore = std::stof(value);
+        else if (arg == "--save-detections") saveDetectionsPath = value;
+        else if (arg == "--output") outputPath = value;
+        else if (arg == "--json") jsonPath = value;
+        else LOG_WARNING("Ignoring unknown argument: %s", arg.c_str());
+    }
+
+    if (!Config::loadFromFile(configPath)) {
+        LOG_ERROR("Failed to load configuration file");
+        return 1;
+    }
+    Logger::getInstance().setLogLevel(Config::getLogLevelMask());
+
+    bool useModel = detector == "model";
+    if (!useModel && detector != "replay") {
+        LOG_ERROR("Unknown detector '%s', expected 'replay' or 'model'", detector.c_str());
+        return 1;
+    }
+
+    auto seqInfo = readSeqInfo(sequenceDir / "seqinfo.ini");
+    std::string imageDir = seqInfo.count("imDir") ? seqInfo["imDir"] : "img1";
+    std::string imageExt = seqInfo.count("imExt") ? seqInfo["imExt"] : ".jpg";
+
+    MOTSequence groundTruth, replayDetections;
+    if (!readMOTFile(sequenceDir / "gt" / "gt.txt", true, 0.0f, groundTruth)) {
+        return 1;
+    }
+    if (!useModel && !readMOTFile(detectionsPath, false, minScore, replayDetections)) {
+        return 1;
+    }
+
+    int seqLength = seqInfo.count("seqLength") ? std::stoi(seqInfo["seqLength"]) : 0;
+    if (seqLength == 0) {
+        if (!groundTruth.empty()) seqLength = std::max(seqLength, groundTruth.rbegin()->first);
+        if (!replayDetections.empty()) seqLength = std::max(seqLength, replayDetections.rbegin()->first);
+    }
+
+    ONNXModel& model = ONNXModel::getInstance();
+    if (useModel && !model.loadModel(Config::getModelPath())) {
+        LOG_ERROR("Failed to load ONNX model");
+        return 1;
+    }
+    if (Config::getReIDEnabled() && !ReIDModel::getInstance().loadModel(Config::getReIDModelPath())) {
+        LOG_ERROR("Failed to load re-identification model");
+        return 1;
+    }
+
+    std::ofstream output, savedDetections;
+    if (!outputPath.empty()) output.open(outputPath);
+    if (!saveDetectionsPath.empty()) savedDetections.open(saveDetectionsPath);
+
+    ThreadSafeQueue<Frame> unusedInput, unusedOutput;
+    Tracker tracker(unusedInput, unusedOutput);
+    MOTEvaluator evaluator(0.5);
+    BenchmarkReport trackerLatency, inferenceLatency;
+
+    LOG_INFO("Evaluating %s: %d frames, detections from %s",
+             sequenceDir.string().c_str(), seqLength, useModel ? "model" : detectionsPath.string().c_str());
+
+    for (int frameNumber = 1; frameNumber <= seqLength; ++frameNumber) {
+        Frame frame;
+        frame.frameIndex = frameNumber - 1;
+
+        if (useModel) {
+            std::ostringstream name;
+            name << std::setw(6) << std::setfill('0') << frameNumber << imageExt;
+            fs::path imagePath = sequenceDir / imageDir / name.str();
+
+            frame.original = cv::imread(imagePath.string());
+            if (frame.original.empty()) {
+                LOG_ERROR("Failed to read %s", imagePath.string().c_str());
+                return 1;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            frame.regions = {InferenceRegion{cv::Rect(cv::Point(0, 0), frame.original.size())}};
+            Ort::Value input = ImageProcessor::preprocessRegionsForONNX(frame.original, frame.regions,
+                Config::getLetterbox(), frame.inputBlob, model.getMemoryInfo(), model.getInputNodeDims(),
+                model.getInputFormat());
+            frame.detections = model.detect(input, frame.regions);
+            auto end = std::chrono::steady_clock::now();
+            inferenceLatency.addLatency(std::chrono::duration<double, std::milli>(end - start).count());
+
+            if (savedDetections.is_open()) {
+                writeMOTLines(savedDetections, frameNumber, frame.detections, {});
+            }
+        } else {
+            for (const auto& det : replayDetections[frameNumber]) {
+                frame.detections.push_back(det.box);
+            }
+        }
+        frame.hasDetections = true;
+
+        auto start = std::chrono::steady_clock::now();
+        tracker.updateTracks(frame);
+        auto end = std::chrono::steady_clock::now();
+        trackerLatency.addLatency(std::chrono::duration<double, std::milli>(end - start).count());
+
+        std::vector<cv::Rect> gtBoxes;
+        std::vector<int> gtIDs;
+        for (const auto& gt : groundTruth[frameNumber]) {
+            gtBoxes.push_back(gt.box);
+            gtIDs.push_back(gt.id);
+        }
+        evaluator.addFrame(gtBoxes, gtIDs, frame.detections, frame.trackIDs);
+
+        if (output.is_open()) {
+            writeMOTLines(output, frameNumber, frame.detections, frame.trackIDs);
+        }
+    }
+
+    MOTMetrics metrics = evaluator.compute();
+
+    LOG_INFO("Evaluation results (%d frames):", metrics.frames);
+    LOG_INFO("   MOTA: %.2f%%  MOTP: %.3f", metrics.mota * 100.0, metrics.motp);
+    LOG_INFO("   IDF1: %.2f%%  (IDP %.2f%%, IDR %.2f%%)", metrics.idf1 * 100.0,
+             metrics.idPrecision * 100.0, metrics.idRecall * 100.0);
+    LOG_INFO("   ID switches: %d  FP: %d  FN: %d", metrics.idSwitches, metrics.falsePositives, metrics.falseNegatives);
+    LOG_INFO("   Tracker latency p50/p99: %.3f / %.3f ms",
+             trackerLatency.latencyPercentile(50), trackerLatency.latencyPercentile(99));
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4);
+    json << "{\n";
+    json << "  \"sequence\": \"" << sequenceDir.filename().string() << "\",\n";
+    json << "  \"detector\": \"" << detector << "\",\n";
+    json << "  \"frames\": " << metrics.frames << ",\n";
+    json << "  \"mota\": " << metrics.mota << ",\n";
+    json << "  \"motp\": " << metrics.motp << ",\n";
+    json << "  \"idf1\": " << metrics.idf1 << ",\n";
+    json << "  \"idp\": " << metrics.idPrecision << ",\n";
+    json << "  \"idr\": " << metrics.idRecall << ",\n";
+    json << "  \"id_switches\": " << metrics.idSwitches << ",\n";
+    json << "  \"false_positives\": " << metrics.falsePositives << ",\n";
+    json << "  \"false_negatives\": " << metrics.falseNegatives << ",\n";
+    json << "  \"ground_truth\": " << metrics.groundTruth << ",\n";
+    json << "  \"tracker_latency_ms\": {\"p50\": " << trackerLatency.latencyPercentile(50)
+         << ", \"p90\": " << trackerLatency.latencyPercentile(90)
+         << ", \"p99\": " << trackerLatency.latencyPercentile(99)
+         << ", \"max\": " << trackerLatency.latencyPercentile(100) << "}";
+    if (useModel) {
+        json << ",\n  \"inference_latency_ms\": {\"p50\": " << inferenceLatency.latencyPercentile(50)
+             << ", \"p99\": " << inferenceLatency.latencyPercentile(99) << "}";
+    }
+    json << "\n}\n";
+
+    if (jsonPath.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream(jsonPath) << json.str();
+    }
+
+    return 0;
+}
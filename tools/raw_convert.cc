@@ -0,0 +1,145 @@
+/**
+ * @file raw_convert.cc
+ * @brief Convert any input the FrameSource can open into a raw or Y4M file
+ *
+ * The result can be played back with "source = raw", which memory-maps the
+ * file instead of decoding it, for repeatable decode-free benchmark runs.
+ *
+ * Usage: raw-convert <config.ini> <output> [options]
+ *   --input <video>        Convert this video instead of the input configured in config.ini
+ *   --format y4m|bgr|nv12  Output layout (default: y4m)
+ *   --max-frames <n>       Stop after n frames
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "logger.h"
+#include "frame.h"
+#include "frame_source.h"
+#include "raw_video_source.h"
+
+/**
+ * @brief Convert a BGR image to planar I420 with even dimensions
+ */
+static cv::Mat toI420(const cv::Mat& bgr) {
+    cv::Mat even = bgr(cv::Rect(0, 0, bgr.cols & ~1, bgr.rows & ~1));
+    cv::Mat i420;
+    cv::cvtColor(even, i420, cv::COLOR_BGR2YUV_I420);
+    return i420;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        LOG_ERROR("Usage: %s <config.ini> <output> [--input <video>] [--format y4m|bgr|nv12] [--max-frames <n>]",
+                  argv[0]);
+        return 1;
+    }
+
+    std::string configPath = argv[1];
+    std::string outputPath = argv[2];
+    std::string inputOverride;
+    std::string formatName = "y4m";
+    long long maxFrames = -1;
+
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--input") inputOverride = value;
+        else if (arg == "--format") formatName = value;
+        else if (arg == "--max-frames") maxFrames = std::stoll(value);
+        else LOG_WARNING("Ignoring unknown argument: %s", arg.c_str());
+    }
+
+    RawVideoSource::Format format;
+    if (!RawVideoSource::parseFormat(formatName, format)) {
+        LOG_ERROR("Unknown output format: %s", formatName.c_str());
+        return 1;
+    }
+
+    if (!Config::loadFromFile(configPath)) {
+        LOG_ERROR("Failed to load configuration file");
+        return 1;
+    }
+    if (!inputOverride.empty()) {
+        Config::setInputSource(Config::InputSource::VIDEO);
+        Config::setVideoPath(inputOverride);
+    }
+
+    FrameSource& frameSource = FrameSource::getInstance();
+    if (!frameSource.initialize()) {
+        LOG_ERROR("Failed to initialize frame source");
+        return 1;
+    }
+
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Failed to create %s", outputPath.c_str());
+        return 1;
+    }
+
+    double fps = frameSource.getFrameRate();
+    if (fps <= 0) fps = 30.0;
+
+    Frame frame;
+    long long frames = 0;
+    cv::Size size;
+    std::vector<uchar> nv12;
+
+    while ((maxFrames < 0 || frames < maxFrames) && frameSource.getNextFrame(frame)) {
+        if (frames == 0) {
+            size = frame.original.size();
+            if (format == RawVideoSource::Format::Y4M) {
+                out << "YUV4MPEG2 W" << (size.width & ~1) << " H" << (size.height & ~1)
+                    << " F" << cvRound(fps * 1000) << ":1000 Ip A1:1 C420jpeg\n";
+            }
+        } else if (frame.original.size() != size) {
+            LOG_ERROR("Frame %lld changes size, raw files need a fixed frame size", frames);
+            return 1;
+        }
+
+        if (format == RawVideoSource::Format::BGR) {
+            cv::Mat bgr = frame.original.isContinuous() ? frame.original : frame.original.clone();
+            out.write(reinterpret_cast<const char*>(bgr.data), bgr.total() * bgr.elemSize());
+        } else {
+            cv::Mat i420 = toI420(frame.original);
+            int w = size.width & ~1;
+            int h = size.height & ~1;
+            size_t lumaBytes = static_cast<size_t>(w) * h;
+            size_t chromaBytes = lumaBytes / 4;
+
+            if (format == RawVideoSource::Format::Y4M) {
+                out << "FRAME\n";
+                out.write(reinterpret_cast<const char*>(i420.data), lumaBytes + 2 * chromaBytes);
+            } else {
+                // NV12 interleaves the U and V planes of I420
+                nv12.resize(lumaBytes + 2 * chromaBytes);
+                std::copy(i420.data, i420.data + lumaBytes, nv12.begin());
+                const uchar* u = i420.data + lumaBytes;
+                const uchar* v = u + chromaBytes;
+                for (size_t i = 0; i < chromaBytes; ++i) {
+                    nv12[lumaBytes + 2 * i] = u[i];
+                    nv12[lumaBytes + 2 * i + 1] = v[i];
+                }
+                out.write(reinterpret_cast<const char*>(nv12.data()), nv12.size());
+            }
+        }
+
+        frames++;
+    }
+
+    if (!out) {
+        LOG_ERROR("Failed while writing %s", outputPath.c_str());
+        return 1;
+    }
+
+    LOG_INFO("Wrote %lld frames (%dx%d, %.2f FPS) to %s as %s", frames, size.width, size.height, fps,
+             outputPath.c_str(), formatName.c_str());
+    if (format != RawVideoSource::Format::Y4M) {
+        LOG_INFO("Play back with: source = raw, raw_format = %s, raw_width = %d, raw_height = %d, raw_fps = %.2f",
+                 formatName.c_str(), format == RawVideoSource::Format::NV12 ? size.width & ~1 : size.width,
+                 format == RawVideoSource::Format::NV12 ? size.height & ~1 : size.height, fps);
+    }
+    return 0;
+}
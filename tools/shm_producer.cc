@@ -0,0 +1,195 @@
+/**
+ * @file shm_producer.cc
+ * @brief Reference producer publishing frames into a shared-memory ring for "source = shm"
+ *
+ * Reads any input the FrameSource can open and publishes its frames the way a
+ * capture daemon would, so the shared-memory source can be run and measured
+ * without one.
+ *
+ * Usage: shm-producer <config.ini> [options]
+ *   --input <video>          Publish this video instead of the input configured in config.ini
+ *   --name <name>            Shared-memory object name (default: shm_name from config.ini)
+ *   --slots <n>              Number of ring slots (default: 4)
+ *   --format bgr|nv12|gray   Pixel layout in the slots (default: bgr)
+ *   --when-full drop|block   Drop frames or wait while the consumer holds every slot (default: drop)
+ *   --pace on|off            Publish at the source frame rate like a live feed (default: on)
+ *   --max-frames <n>         Stop after n frames
+ */
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "config.h"
+#include "logger.h"
+#include "frame.h"
+#include "frame_source.h"
+#include "shm_frame_ring.h"
+
+static std::atomic<bool> stopRequested(false);
+
+static void requestStop(int) {
+    stopRequested = true;
+}
+
+/**
+ * @brief Parse a pixel format name
+ */
+static bool parseFormat(const std::string& name, ShmPixelFormat& format) {
+    if (name == "bgr") format = ShmPixelFormat::BGR;
+    else if (name == "nv12") format = ShmPixelFormat::NV12;
+    else if (name == "gray") format = ShmPixelFormat::GRAY;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Convert a BGR frame into a slot and return the bytes per row of its first plane
+ */
+static uint32_t writeFrame(const cv::Mat& bgr, ShmPixelFormat format, uint8_t* slot, cv::Size& size) {
+    if (format == ShmPixelFormat::BGR) {
+        size = bgr.size();
+        cv::Mat view(size, CV_8UC3, slot);
+        bgr.copyTo(view);
+        return static_cast<uint32_t>(size.width * 3);
+    }
+    if (format == ShmPixelFormat::GRAY) {
+        size = bgr.size();
+        cv::Mat view(size, CV_8UC1, slot);
+        cv::cvtColor(bgr, view, cv::COLOR_BGR2GRAY);
+        return static_cast<uint32_t>(size.width);
+    }
+
+    // NV12 interleaves the chroma planes of I420
+    size = cv::Size(bgr.cols & ~1, bgr.rows & ~1);
+    cv::Mat i420;
+    cv::cvtColor(bgr(cv::Rect(cv::Point(0, 0), size)), i420, cv::COLOR_BGR2YUV_I420);
+    size_t lumaBytes = static_cast<size_t>(size.area());
+    size_t chromaBytes = lumaBytes / 4;
+    std::memcpy(slot, i420.data, lumaBytes);
+    const uchar* u = i420.data + lumaBytes;
+    const uchar* v = u + chromaBytes;
+    for (size_t i = 0; i < chromaBytes; ++i) {
+        slot[lumaBytes + 2 * i] = u[i];
+        slot[lumaBytes + 2 * i + 1] = v[i];
+    }
+    return static_cast<uint32_t>(size.width);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        LOG_ERROR("Usage: %s <config.ini> [--input <video>] [--name <name>] [--slots <n>] [--format bgr|nv12|gray] "
+                  "[--when-full drop|block] [--pace on|off] [--max-frames <n>]", argv[0]);
+        return 1;
+    }
+
+    std::string configPath = argv[1];
+    std::string inputOverride;
+    std::string name;
+    std::string formatName = "bgr";
+    uint32_t slots = 4;
+    bool block = false;
+    bool paced = true;
+    long long maxFrames = -1;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--input") inputOverride = value;
+        else if (arg == "--name") name = value;
+        else if (arg == "--slots") slots = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--format") formatName = value;
+        else if (arg == "--when-full") block = value == "block";
+        else if (arg == "--pace") paced = value != "off";
+        else if (arg == "--max-frames") maxFrames = std::stoll(value);
+        else LOG_WARNING("Ignoring unknown argument: %s", arg.c_str());
+    }
+
+    ShmPixelFormat format;
+    if (!parseFormat(formatName, format)) {
+        LOG_ERROR("Unknown pixel format: %s", formatName.c_str());
+        return 1;
+    }
+
+    if (!Config::loadFromFile(configPath)) {
+        LOG_ERROR("Failed to load configuration file");
+        return 1;
+    }
+    if (name.empty()) {
+        name = Config::getShmName();
+    }
+    if (!inputOverride.empty()) {
+        Config::setInputSource(Config::InputSource::VIDEO);
+        Config::setVideoPath(inputOverride);
+    }
+    if (Config::getInputSource() == Config::InputSource::SHM) {
+        LOG_ERROR("The producer needs a video, camera, raw or image input; set --input");
+        return 1;
+    }
+
+    FrameSource& frameSource = FrameSource::getInstance();
+    if (!frameSource.initialize()) {
+        LOG_ERROR("Failed to initialize frame source");
+        return 1;
+    }
+
+    // The first frame sizes the slots
+    Frame frame;
+    if (!frameSource.getNextFrame(frame)) {
+        LOG_ERROR("Input has no frames");
+        return 1;
+    }
+    cv::Size inputSize = frame.original.size();
+    double fps = frameSource.getFrameRate();
+    std::unique_ptr<ShmFrameRing> ring = ShmFrameRing::create(name, slots,
+                                                              static_cast<size_t>(inputSize.area()) * 3, fps);
+    if (!ring) {
+        return 1;
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / (fps > 0 ? fps : 30.0)));
+    auto nextPublish = std::chrono::steady_clock::now();
+    long long frames = 0;
+
+    do {
+        if (frame.original.size() != inputSize) {
+            LOG_ERROR("Frame %lld changes size, the ring slots have a fixed size", frames);
+            break;
+        }
+
+        // Waiting in short steps keeps a blocked producer responsive to Ctrl+C
+        int slot = ring->beginWrite(std::chrono::milliseconds(0));
+        while (slot < 0 && block && !stopRequested) {
+            slot = ring->beginWrite(std::chrono::milliseconds(100));
+        }
+
+        if (slot < 0) {
+            ring->countDropped();
+        } else {
+            cv::Size size;
+            uint32_t stride = writeFrame(frame.original, format, ring->data(slot), size);
+            int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                frame.captureTime.time_since_epoch()).count();
+            ring->publish(slot, static_cast<uint32_t>(size.width), static_cast<uint32_t>(size.height), format,
+                          stride, timestamp);
+        }
+        frames++;
+
+        if (paced) {
+            nextPublish += interval;
+            std::this_thread::sleep_until(nextPublish);
+        }
+    } while (!stopRequested && (maxFrames < 0 || frames < maxFrames) && frameSource.getNextFrame(frame));
+
+    ring->close();
+    LOG_INFO("Published %llu of %lld frames (%dx%d %s) to %s, %llu dropped",
+             static_cast<unsigned long long>(ring->published()), frames, inputSize.width, inputSize.height,
+             formatName.c_str(), name.c_str(), static_cast<unsigned long long>(ring->dropped()));
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file track_replay.cc
+ * @brief Render a stored track log onto its source video without running inference
+ *
+ * Frames are read through the FrameSource configured in config.ini and matched
+ * to log entries by frame index. The annotated frames are shown in a window, or
+ * written to a video file when --output is given.
+ *
+ * Usage: track-replay <config.ini> <track_log> [options]
+ *   --input <video>    Replay onto this video instead of the input configured in config.ini
+ *   --output <video>   Write the annotated video instead of showing it
+ *   --fourcc <code>    Codec of the output video (default: mp4v)
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "logger.h"
+#include "frame.h"
+#include "frame_source.h"
+#include "display.h"
+#include "track_log.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        LOG_ERROR("Usage: %s <config.ini> <track_log> [--input <video>] [--output <video>] [--fourcc <code>]",
+                  argv[0]);
+        return 1;
+    }
+
+    std::string configPath = argv[1];
+    std::string logPath = argv[2];
+    std::string inputOverride;
+    std::string outputPath;
+    std::string fourcc = "mp4v";
+
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--input") inputOverride = value;
+        else if (arg == "--output") outputPath = value;
+        else if (arg == "--fourcc") fourcc = value;
+        else LOG_WARNING("Ignoring unknown argument: %s", arg.c_str());
+    }
+
+    if (fourcc.size() != 4) {
+        LOG_ERROR("Invalid fourcc: %s", fourcc.c_str());
+        return 1;
+    }
+
+    TrackLogReader trackLog;
+    if (!trackLog.open(logPath)) {
+        return 1;
+    }
+    LOG_INFO("Track log %s: %zu frames", logPath.c_str(), trackLog.frameCount());
+
+    if (!Config::loadFromFile(configPath)) {
+        LOG_ERROR("Failed to load configuration file");
+        return 1;
+    }
+    if (!inputOverride.empty()) {
+        Config::setInputSource(Config::InputSource::VIDEO);
+        Config::setVideoPath(inputOverride);
+    }
+
+    FrameSource& frameSource = FrameSource::getInstance();
+    if (!frameSource.initialize()) {
+        LOG_ERROR("Failed to initialize frame source");
+        return 1;
+    }
+
+    double fps = frameSource.getFrameRate();
+    if (fps <= 0) fps = 30.0;
+
+    const std::string windowName = "Track Replay";
+    cv::VideoWriter writer;
+    if (outputPath.empty()) {
+        cv::namedWindow(windowName, cv::WINDOW_AUTOSIZE);
+    }
+
+    Frame frame;
+    long long frames = 0;
+    long long matched = 0;
+
+    while (frameSource.getNextFrame(frame)) {
+        if (Display::loadLoggedTracks(frame, trackLog)) {
+            matched++;
+        }
+
+        cv::Mat annotated = Display::renderFrame(frame, true, fps);
+        frames++;
+
+        if (outputPath.empty()) {
+            cv::imshow(windowName, annotated);
+            int key = cv::waitKey(std::max(1, static_cast<int>(1000.0 / fps)));
+            if (key == 'q' || key == 'Q' || key == 27) break;
+            continue;
+        }
+
+        if (!writer.isOpened() &&
+            !writer.open(outputPath, cv::VideoWriter::fourcc(fourcc[0], fourcc[1], fourcc[2], fourcc[3]),
+                         fps, annotated.size())) {
+            LOG_ERROR("Failed to open output video %s", outputPath.c_str());
+            return 1;
+        }
+        writer.write(annotated);
+    }
+
+    if (outputPath.empty()) {
+        cv::destroyWindow(windowName);
+    }
+
+    LOG_INFO("Replayed %lld frames, %lld with logged tracks", frames, matched);
+    return 0;
+}
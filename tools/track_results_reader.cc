@@ -0,0 +1,86 @@
+/**
+ * @file track_results_reader.cc
+ * @brief Example consumer of the shared-memory tracking results
+ *
+ * Links only the track-results library, as an analytics process would. Prints
+ * each frame's tracks and the time since the frame was captured.
+ *
+ * Usage: track-results-reader [options]
+ *   --name <name>     Shared-memory object name (default: /object-tracking-results)
+ *   --follow on|off   Read every frame in order instead of only the newest one (default: off)
+ *   --frames <n>      Stop after n frames
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "logger.h"
+#include "track_results.h"
+
+/**
+ * @brief Print one frame's tracks on one line
+ */
+static void printFrame(const TrackResultsFrame& frame) {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::cout << "frame " << frame.frameIndex << " (" << frame.frameWidth << "x" << frame.frameHeight << ", "
+              << (now - frame.captureTimeNs) / 1e6 << " ms old): " << frame.tracks.size() << " tracks";
+    for (const TrackRecord& track : frame.tracks) {
+        std::cout << " " << track.trackId << "@" << track.x << "," << track.y << "," << track.width << "x"
+                  << track.height;
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = "/object-tracking-results";
+    bool follow = false;
+    long long maxFrames = -1;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--name") name = value;
+        else if (arg == "--follow") follow = value == "on";
+        else if (arg == "--frames") maxFrames = std::stoll(value);
+        else LOG_WARNING("Ignoring unknown argument: %s", arg.c_str());
+    }
+
+    std::unique_ptr<TrackResultsReader> reader;
+    while (!(reader = TrackResultsReader::attach(name))) {
+        LOG_INFO("Waiting for %s", name.c_str());
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    TrackResultsFrame frame;
+    uint64_t next = reader->latest() + 1;
+    long long frames = 0;
+    uint64_t missed = 0;
+
+    while (maxFrames < 0 || frames < maxFrames) {
+        uint64_t latest = reader->latest();
+        if (latest < next) {
+            if (reader->isClosed()) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // Only the newest frame matters unless following; a follower that fell a ring behind skips ahead
+        if (!follow || latest - next >= reader->slotCount()) {
+            missed += latest - next;
+            next = latest;
+        }
+        if (reader->read(next, frame)) {
+            printFrame(frame);
+            frames++;
+        } else {
+            missed++;
+        }
+        next++;
+    }
+
+    LOG_INFO("Read %lld frames, skipped %llu, %llu torn reads retried", frames,
+             static_cast<unsigned long long>(missed), static_cast<unsigned long long>(reader->tornReads()));
+    return 0;
+}